@@ -0,0 +1,111 @@
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Command Buffer Pool
+
+#ifndef COMMAND_BUFFER_POOL
+#define COMMAND_BUFFER_POOL
+
+#include "Common.h"
+
+namespace VulkanCookbook {
+
+  struct CommandBufferPoolStatistics {
+    uint64_t    CommandBuffersAllocated;
+    uint64_t    AllocationsAvoided;
+    uint64_t    CommandPoolResets;
+    uint64_t    CommandBufferResets;
+  };
+
+  // Command buffers of one queue family and level allocated from one pool
+  struct RecycledCommandBuffers {
+    uint32_t                                          QueueFamily;
+    VkCommandBufferLevel                              Level;
+    VkDestroyer(VkCommandPool)                        Pool;
+    std::vector<VkCommandBuffer>                      CommandBuffers;
+    // Frame pools: number of command buffers handed out since the last reset
+    uint32_t                                          UsedCount;
+    // Fence tracked pools: handed out, submitted and ready to reuse command buffers
+    std::vector<VkCommandBuffer>                      Acquired;
+    std::vector<std::pair<VkCommandBuffer, VkFence>>  Submitted;
+    std::vector<VkCommandBuffer>                      Available;
+  };
+
+  // Hands out command buffers keyed by queue family and level, recycling them
+  // instead of allocating and freeing them on every use. Not thread safe - use
+  // one object per recording thread.
+  //
+  // Frame command buffers come from per frame slot pools, which are reset as a
+  // whole with vkResetCommandPool when the slot comes around again. Other
+  // command buffers are returned together with the fence of their submission
+  // and handed out again once the fence is signaled.
+  class CommandBufferPool {
+  public:
+    CommandBufferPool();
+    ~CommandBufferPool();
+
+    bool Initialize( DeviceDispatch const & dispatch,
+                     uint32_t               frames_in_flight );
+    void Destroy();
+
+    // Resets pools of the frame_index % frames_in_flight slot. The previous
+    // submission which used this slot must have completed (e.g. its fence was
+    // waited on by FrameLoop)
+    bool BeginFrame( uint64_t frame_index );
+
+    // Valid until the frame slot is begun again
+    bool AcquireFrameCommandBuffer( uint32_t               queue_family,
+                                    VkCommandBufferLevel   level,
+                                    VkCommandBuffer      & command_buffer );
+
+    // Valid until returned with ReleaseCommandBuffer()
+    bool AcquireCommandBuffer( uint32_t               queue_family,
+                               VkCommandBufferLevel   level,
+                               VkCommandBuffer      & command_buffer );
+
+    // The command buffer is reused after the fence is signaled; VK_NULL_HANDLE
+    // when it was never submitted. The fence must not be reset before that
+    void ReleaseCommandBuffer( VkCommandBuffer   command_buffer,
+                               VkFence           fence );
+
+    CommandBufferPoolStatistics const & GetStatistics() const {
+      return Statistics;
+    }
+
+    CommandBufferPool( CommandBufferPool const & ) = delete;
+    CommandBufferPool& operator=( CommandBufferPool const & ) = delete;
+
+  private:
+    RecycledCommandBuffers * FindPool( std::vector<std::unique_ptr<RecycledCommandBuffers>> & pools,
+                                       uint32_t                                               queue_family,
+                                       VkCommandBufferLevel                                   level,
+                                       VkCommandPoolCreateFlags                               flags );
+    bool AllocateCommandBuffer( RecycledCommandBuffers & pool );
+
+    DeviceDispatch const                                              * Dispatch;
+    uint32_t                                                            CurrentFrame;
+    std::vector<std::vector<std::unique_ptr<RecycledCommandBuffers>>>   FramePools;
+    std::vector<std::unique_ptr<RecycledCommandBuffers>>                TrackedPools;
+    CommandBufferPoolStatistics                                         Statistics;
+  };
+
+} // namespace VulkanCookbook
+
+#endif // COMMAND_BUFFER_POOL
@@ -0,0 +1,78 @@
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Command Buffers and Synchronization
+
+#ifndef COMMAND_BUFFERS
+#define COMMAND_BUFFERS
+
+#include "Common.h"
+
+namespace VulkanCookbook {
+
+  struct WaitSemaphoreInfo {
+    VkSemaphore           Semaphore;
+    VkPipelineStageFlags  WaitingStage;
+  };
+
+  bool CreateCommandPool( DeviceDispatch const     & dispatch,
+                          VkCommandPoolCreateFlags   parameters,
+                          uint32_t                   queue_family,
+                          VkCommandPool            & command_pool );
+
+  bool AllocateCommandBuffers( DeviceDispatch const         & dispatch,
+                               VkCommandPool                  command_pool,
+                               VkCommandBufferLevel           level,
+                               uint32_t                       count,
+                               std::vector<VkCommandBuffer> & command_buffers );
+
+  bool BeginCommandBufferRecordingOperation( DeviceDispatch const           & dispatch,
+                                             VkCommandBuffer                  command_buffer,
+                                             VkCommandBufferUsageFlags        usage,
+                                             VkCommandBufferInheritanceInfo * secondary_command_buffer_info );
+
+  bool EndCommandBufferRecordingOperation( DeviceDispatch const & dispatch,
+                                           VkCommandBuffer        command_buffer );
+
+  bool CreateSemaphore( DeviceDispatch const & dispatch,
+                        VkSemaphore          & semaphore );
+
+  bool CreateFence( DeviceDispatch const & dispatch,
+                    bool                   signaled,
+                    VkFence              & fence );
+
+  bool WaitForFences( DeviceDispatch const       & dispatch,
+                      std::vector<VkFence> const & fences,
+                      VkBool32                     wait_for_all,
+                      uint64_t                     timeout );
+
+  bool ResetFences( DeviceDispatch const       & dispatch,
+                    std::vector<VkFence> const & fences );
+
+  bool SubmitCommandBuffersToQueue( DeviceDispatch const           & dispatch,
+                                    VkQueue                          queue,
+                                    std::vector<WaitSemaphoreInfo>   wait_semaphore_infos,
+                                    std::vector<VkCommandBuffer>     command_buffers,
+                                    std::vector<VkSemaphore>         signal_semaphores,
+                                    VkFence                          fence );
+
+} // namespace VulkanCookbook
+
+#endif // COMMAND_BUFFERS
@@ -0,0 +1,82 @@
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Command Recorder
+
+#ifndef COMMAND_RECORDER
+#define COMMAND_RECORDER
+
+#include "Common.h"
+#include "CommandBufferPool.h"
+#include "ThreadPool.h"
+
+namespace VulkanCookbook {
+
+  // Records secondary command buffers in parallel on a thread pool and executes
+  // them in the primary command buffer. Every worker thread has its own
+  // CommandBufferPool, so recording needs no locking, and all command buffers
+  // of a frame are recycled at once with vkResetCommandPool.
+  //
+  // Frames are used in the same order as in FrameLoop - BeginFrame() must only
+  // be called after the previous submission of the frame slot has completed.
+  class CommandRecorder {
+  public:
+    // Receives the secondary command buffer (in the recording state) and the index of the job
+    using RecordFunction = std::function<bool( VkCommandBuffer, uint32_t )>;
+
+    CommandRecorder();
+    ~CommandRecorder();
+
+    bool Initialize( DeviceDispatch const & dispatch,
+                     uint32_t               queue_family,
+                     ThreadPool           & thread_pool,
+                     uint32_t               frames_in_flight );
+    void Destroy();
+
+    // Resets command pools of the frame_index % frames_in_flight slot
+    bool BeginFrame( uint64_t frame_index );
+
+    // Records each job into its own secondary command buffer in parallel and
+    // executes them in job order with a single vkCmdExecuteCommands. When
+    // inheritance.renderPass is set, primary_command_buffer must be inside that
+    // render pass begun with VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS.
+    // Must not be called from a task of the thread pool.
+    bool RecordAndExecute( VkCommandBuffer                         primary_command_buffer,
+                           VkCommandBufferInheritanceInfo const  & inheritance,
+                           std::vector<RecordFunction> const     & jobs );
+
+    // Sum over all worker threads
+    CommandBufferPoolStatistics GetStatistics() const;
+
+    CommandRecorder( CommandRecorder const & ) = delete;
+    CommandRecorder& operator=( CommandRecorder const & ) = delete;
+
+  private:
+    DeviceDispatch const                            * Dispatch;
+    uint32_t                                          QueueFamily;
+    ThreadPool                                      * Workers;
+    bool                                              FrameStarted;
+    // Indexed with worker index
+    std::vector<std::unique_ptr<CommandBufferPool>>   Pools;
+  };
+
+} // namespace VulkanCookbook
+
+#endif // COMMAND_RECORDER
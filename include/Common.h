@@ -48,6 +48,7 @@
 #include <functional>
 #include <memory>
 #include "VulkanDestroyer.h"
+#include "ExtensionTable.h"
 
 //namespace VulkanCookbook {
 
@@ -83,10 +84,17 @@ namespace VulkanCookbook {
   bool LoadFunctionExportedFromVulkanLoaderLibrary( LIBRARY_TYPE const & vulkan_library );
   bool LoadGlobalLevelFunctions();
   bool LoadInstanceLevelFunctions( VkInstance instance, std::vector<char const *> const & enabled_extensions );
-  bool LoadDeviceLevelFunctions( VkDevice logical_device, std::vector<char const *> const & enabled_extensions );
+  bool LoadDeviceLevelFunctions( VkDevice logical_device, std::vector<char const *> const & enabled_extensions, uint32_t api_version = VK_API_VERSION_1_0 );
+  bool LoadDeviceLevelFunctions( VkDevice logical_device, std::vector<char const *> const & enabled_extensions, DeviceDispatch & dispatch, uint32_t api_version = VK_API_VERSION_1_0 );
+  // Highest API version (up to 1.3) supported by the loader, used as VkApplicationInfo::apiVersion
+  uint32_t SelectInstanceApiVersion();
+  // Version usable with a physical device: the lower of the instance and device versions
+  uint32_t GetNegotiatedApiVersion( VkPhysicalDevice physical_device );
   void ReleaseVulkanLoaderLibrary( LIBRARY_TYPE & vulkan_library );
   bool IsExtensionSupported( std::vector<VkExtensionProperties> const & available_extensions,
                              char const * const                         extension );
+  bool IsExtensionSupported( ExtensionTable const & available_extensions,
+                             char const * const     extension );
 
   bool IsLayerSupported( std::vector<VkLayerProperties> const & available_layers,
                              char const * const                         layer );
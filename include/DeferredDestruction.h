@@ -0,0 +1,107 @@
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Deferred Destruction
+
+#ifndef DEFERRED_DESTRUCTION
+#define DEFERRED_DESTRUCTION
+
+#include <deque>
+#include <memory>
+#include <mutex>
+#include "Common.h"
+
+namespace VulkanCookbook {
+
+  // Keeps objects alive until the GPU work which may still use them has
+  // completed, instead of idling the whole device before destroying them.
+  //
+  // Values are anything monotonic which the caller can query completion of -
+  // a timeline semaphore value (TimelineScheduler::GetCompletedValue()) or a
+  // number of frames whose fences were waited on. Objects are destroyed in
+  // bulk by Collect(). Thread safe.
+  class DeferredDestructionQueue {
+  public:
+    DeferredDestructionQueue();
+    ~DeferredDestructionQueue();
+
+    // Value of the most recent work which may reference objects retired from now on
+    void SetCurrentValue( uint64_t value );
+
+    uint64_t GetCurrentValue() const;
+
+    // The destroyer is left empty
+    template<class VkTypeWrapper>
+    void Retire( VkDestroyer<VkTypeWrapper> && object ) {
+      Retire( std::move( object ), GetCurrentValue() );
+    }
+
+    template<class VkTypeWrapper>
+    void Retire( VkDestroyer<VkTypeWrapper> && object,
+                 uint64_t                      value ) {
+      if( object ) {
+        Retire( std::unique_ptr<RetiredObject>( new RetiredVkObject<VkTypeWrapper>( std::move( object ) ) ), value );
+      }
+    }
+
+    // Destroys objects retired with values up to and including the completed one
+    void Collect( uint64_t completed_value );
+
+    // Only when the device no longer uses any of the objects
+    void DestroyAll();
+
+    size_t GetRetiredObjectCount() const;
+
+    DeferredDestructionQueue( DeferredDestructionQueue const & ) = delete;
+    DeferredDestructionQueue& operator=( DeferredDestructionQueue const & ) = delete;
+
+  private:
+    struct RetiredObject {
+      virtual ~RetiredObject() {
+      }
+    };
+
+    template<class VkTypeWrapper>
+    struct RetiredVkObject : public RetiredObject {
+      RetiredVkObject( VkDestroyer<VkTypeWrapper> && object ) :
+        Object( std::move( object ) ) {
+      }
+
+      VkDestroyer<VkTypeWrapper> Object;
+    };
+
+    struct RetiredGroup {
+      uint64_t                                      Value;
+      std::vector<std::unique_ptr<RetiredObject>>   Objects;
+    };
+
+    void Retire( std::unique_ptr<RetiredObject> object,
+                 uint64_t                       value );
+
+    mutable std::mutex              Mutex;
+    // Sorted by value
+    std::deque<RetiredGroup>        Groups;
+    uint64_t                        CurrentValue;
+    size_t                          RetiredObjectCount;
+  };
+
+} // namespace VulkanCookbook
+
+#endif // DEFERRED_DESTRUCTION
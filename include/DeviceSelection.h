@@ -0,0 +1,71 @@
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Device Selection
+
+#ifndef DEVICE_SELECTION
+#define DEVICE_SELECTION
+
+#include "Common.h"
+
+namespace VulkanCookbook {
+
+  struct DeviceRequirements {
+    std::vector<char const *>   Extensions;
+    VkPhysicalDeviceFeatures    Features;               // Every VK_TRUE member must be supported
+    VkQueueFlags                QueueCapabilities;      // Must all be available in a single family
+    VkSurfaceKHR                PresentationSurface;    // VK_NULL_HANDLE when presentation is not needed
+  };
+
+  // Members up to QueueTopologyRank are compared in declaration order, the
+  // bigger value wins; Name is only used for reporting
+  struct PhysicalDeviceScore {
+    VkPhysicalDevice    PhysicalDevice;
+    bool                MeetsRequirements;
+    uint32_t            TypeRank;
+    VkDeviceSize        DeviceLocalMemorySize;
+    uint32_t            QueueTopologyRank;
+    std::string         Name;
+  };
+
+  DeviceRequirements MakeDeviceRequirements( VkQueueFlags queue_capabilities );
+
+  PhysicalDeviceScore ScorePhysicalDevice( VkPhysicalDevice           physical_device,
+                                           DeviceRequirements const & requirements );
+
+  // Best devices first; devices which do not meet the requirements are kept at the end
+  bool RankPhysicalDevices( VkInstance                         instance,
+                            DeviceRequirements const         & requirements,
+                            std::vector<PhysicalDeviceScore> & ranked_devices );
+
+  // Matches a hexadecimal deviceUUID (dashes are ignored) or a case insensitive part of the device name.
+  // The UUID is only known for Vulkan 1.1 devices on a Vulkan 1.1 instance
+  bool MatchPhysicalDevice( VkPhysicalDevice    physical_device,
+                            std::string const & name_or_uuid );
+
+  // An empty override selects the best ranked device meeting the requirements
+  bool SelectPhysicalDevice( VkInstance                 instance,
+                             DeviceRequirements const & requirements,
+                             std::string const        & name_or_uuid_override,
+                             VkPhysicalDevice         & physical_device );
+
+} // namespace VulkanCookbook
+
+#endif // DEVICE_SELECTION
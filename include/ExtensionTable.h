@@ -0,0 +1,115 @@
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Extension Table
+
+#ifndef EXTENSION_TABLE
+#define EXTENSION_TABLE
+
+#include <array>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+#include "VulkanFunctions.h"
+
+namespace VulkanCookbook {
+
+  // FNV-1a, usable in constant expressions so extension name literals
+  // from ListOfVulkanFunctions.inl are hashed at compile time
+  constexpr uint32_t HashExtensionName( char const * name, uint32_t hash = 2166136261u ) {
+    return (0 == *name) ? hash : HashExtensionName( name + 1, (hash ^ static_cast<unsigned char>(*name)) * 16777619u );
+  }
+
+  // Forces compile-time evaluation of the hash of a string literal
+  #define EXTENSION_NAME_HASH( extension ) std::integral_constant<uint32_t, VulkanCookbook::HashExtensionName( extension )>::value
+
+  // Fixed-size open addressing set of extension names. It never allocates,
+  // and stores pointers only - the names must outlive the table.
+  class ExtensionTable {
+  public:
+    static constexpr uint32_t Capacity = 1024;
+
+    ExtensionTable() :
+      Count( 0 ) {
+      Names.fill( nullptr );
+    }
+
+    explicit ExtensionTable( std::vector<char const *> const & extensions ) :
+      ExtensionTable() {
+      for( auto & extension : extensions ) {
+        Insert( extension );
+      }
+    }
+
+    explicit ExtensionTable( std::vector<VkExtensionProperties> const & extensions ) :
+      ExtensionTable() {
+      for( auto & extension : extensions ) {
+        Insert( extension.extensionName );
+      }
+    }
+
+    bool Insert( char const * name ) {
+      uint32_t hash = HashExtensionName( name );
+      if( Contains( hash, name ) ) {
+        return true;
+      }
+      // Keep the load factor at or below one half so probe sequences stay short
+      if( 2 * (Count + 1) > Capacity ) {
+        return false;
+      }
+      uint32_t slot = hash & (Capacity - 1);
+      while( nullptr != Names[slot] ) {
+        slot = (slot + 1) & (Capacity - 1);
+      }
+      Hashes[slot] = hash;
+      Names[slot] = name;
+      ++Count;
+      return true;
+    }
+
+    bool Contains( uint32_t hash, char const * name ) const {
+      uint32_t slot = hash & (Capacity - 1);
+      while( nullptr != Names[slot] ) {
+        if( (Hashes[slot] == hash) &&
+            (0 == strcmp( Names[slot], name )) ) {
+          return true;
+        }
+        slot = (slot + 1) & (Capacity - 1);
+      }
+      return false;
+    }
+
+    bool Contains( char const * name ) const {
+      return Contains( HashExtensionName( name ), name );
+    }
+
+    uint32_t GetCount() const {
+      return Count;
+    }
+
+  private:
+    std::array<uint32_t, Capacity>        Hashes;
+    std::array<char const *, Capacity>    Names;
+    uint32_t                              Count;
+  };
+
+} // namespace VulkanCookbook
+
+#endif // EXTENSION_TABLE
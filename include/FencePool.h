@@ -0,0 +1,130 @@
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Fence Pool
+
+#ifndef FENCE_POOL
+#define FENCE_POOL
+
+#include <deque>
+#include "Common.h"
+
+namespace VulkanCookbook {
+
+  struct FencePoolStatistics {
+    uint64_t    FencesCreated;
+    uint64_t    FencesReused;
+  };
+
+  // Recycles unsignaled fences instead of creating and destroying one per
+  // submission. Released fences are reset together with a single
+  // vkResetFences call when the pool runs out. Not thread safe.
+  //
+  // All calls go through the dispatch table of the device, which has to
+  // outlive the pool, so pools of several devices can coexist.
+  class FencePool {
+  public:
+    FencePool();
+    ~FencePool();
+
+    bool Initialize( DeviceDispatch const & dispatch );
+    void Destroy();
+
+    // The fence is unsignaled
+    bool Acquire( VkFence & fence );
+
+    // The fence must be signaled or not used by any pending submission
+    void Release( VkFence fence );
+
+    FencePoolStatistics const & GetStatistics() const {
+      return Statistics;
+    }
+
+    FencePool( FencePool const & ) = delete;
+    FencePool& operator=( FencePool const & ) = delete;
+
+  private:
+    DeviceDispatch const              * Dispatch;
+    std::vector<VkDestroyer(VkFence)>   Fences;
+    std::vector<VkFence>                Available;
+    std::vector<VkFence>                Released;
+    FencePoolStatistics                 Statistics;
+  };
+
+  // Tracks submissions with fences from a FencePool and runs callbacks (freeing
+  // resources, reclaiming ring buffer space, ...) once the GPU has finished
+  // them. Poll() never blocks, so the CPU keeps working ahead of the GPU.
+  // Not thread safe.
+  class CompletionTracker {
+  public:
+    CompletionTracker();
+    ~CompletionTracker();
+
+    bool Initialize( DeviceDispatch const & dispatch,
+                     FencePool            & fence_pool );
+    void Destroy();
+
+    // The fence has to be passed to the submission - otherwise it never completes
+    bool BeginSubmission( VkFence  & fence,
+                          uint64_t & submission_id );
+
+    // For submissions which failed - the fence is returned to the pool and the
+    // callbacks are executed by the next Poll()
+    void CancelSubmission( uint64_t submission_id );
+
+    // Executed by the Poll() or Wait...() call which notices the completion,
+    // also when the submission has already completed
+    void OnComplete( uint64_t              submission_id,
+                     std::function<void()> callback );
+
+    // Checks fences of all pending submissions with vkGetFenceStatus, as
+    // submissions to different queues may complete in any order
+    void Poll();
+
+    bool IsComplete( uint64_t submission_id ) const;
+
+    bool WaitForSubmission( uint64_t submission_id,
+                            uint64_t timeout = UINT64_MAX );
+
+    bool WaitIdle();
+
+    CompletionTracker( CompletionTracker const & ) = delete;
+    CompletionTracker& operator=( CompletionTracker const & ) = delete;
+
+  private:
+    struct PendingSubmission {
+      uint64_t                            Id;
+      VkFence                             Fence;
+      std::vector<std::function<void()>>  Callbacks;
+    };
+
+    void Complete( PendingSubmission & submission );
+
+    DeviceDispatch const                * Dispatch;
+    FencePool                           * Fences;
+    std::deque<PendingSubmission>         PendingSubmissions;
+    // Callbacks registered for already completed submissions
+    std::vector<std::function<void()>>    ReadyCallbacks;
+    uint64_t                              NextSubmissionId;
+  };
+
+} // namespace VulkanCookbook
+
+#endif // FENCE_POOL
@@ -0,0 +1,137 @@
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Frame Loop
+
+#ifndef FRAME_LOOP
+#define FRAME_LOOP
+
+#include "Common.h"
+#include "CommandBuffers.h"
+#include "DeferredDestruction.h"
+#include "SubmitBatcher.h"
+#include "Swapchain.h"
+
+namespace VulkanCookbook {
+
+  struct FrameResources {
+    VkCommandBuffer             CommandBuffer;
+    VkDestroyer(VkSemaphore)    ImageAcquiredSemaphore;
+    VkDestroyer(VkSemaphore)    ReadyToPresentSemaphore;
+    VkDestroyer(VkFence)        DrawingFinishedFence;
+  };
+
+  struct RetiredSwapchain {
+    SwapchainState    Swapchain;
+    uint64_t          LastFrameIndex;
+  };
+
+  // Cycles through a fixed set of frame resources, so the CPU can record the
+  // next frame while the GPU still executes the previous ones. The fence of a
+  // frame is only waited on when its resources come around again.
+  //
+  // Replaced swapchains are kept alive until the fences of all the frames that
+  // used them have been waited on, so recreation never idles the device. Other
+  // objects can be retired the same way through GetDestructionQueue().
+  //
+  // With a submit batcher, the frame is added to it and all of its queues are
+  // flushed right before presenting, so the work other subsystems added during
+  // the frame is submitted with one vkQueueSubmit per queue.
+  class FrameLoop {
+  public:
+    static constexpr uint32_t DefaultFramesInFlight = 2;
+
+    // Called with the acquired image index. Commands recorded by the callback
+    // must synchronize with the VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT
+    // stage, at which the acquire semaphore is waited on, and leave the image
+    // in the VK_IMAGE_LAYOUT_PRESENT_SRC_KHR layout.
+    using RecordFunction = std::function<bool( VkCommandBuffer, uint32_t )>;
+
+    FrameLoop();
+    ~FrameLoop();
+
+    bool Initialize( DeviceDispatch const & dispatch,
+                     uint32_t               graphics_queue_family,
+                     VkQueue                graphics_queue,
+                     uint32_t               present_queue_family,
+                     VkQueue                present_queue,
+                     uint32_t               frames_in_flight = DefaultFramesInFlight,
+                     SubmitBatcher        * submit_batcher = nullptr );
+    void Destroy();
+
+    // Returns true without rendering anything when the swapchain is out of
+    // date; check IsSwapchainOutOfDate() and call RecreateSwapchain()
+    bool RenderFrame( SwapchainState       & swapchain,
+                      RecordFunction const & record_command_buffer );
+
+    bool RecreateSwapchain( VkPhysicalDevice    physical_device,
+                            VkSurfaceKHR        presentation_surface,
+                            uint32_t            image_count,
+                            VkPresentModeKHR    present_mode,
+                            VkImageUsageFlags   image_usage,
+                            SwapchainState    & swapchain );
+
+    bool IsSwapchainOutOfDate() const {
+      return SwapchainOutOfDate;
+    }
+
+    bool WaitForAllFrames();
+
+    uint64_t GetFrameIndex() const {
+      return FrameIndex;
+    }
+
+    uint32_t GetFramesInFlight() const {
+      return static_cast<uint32_t>(Frames.size());
+    }
+
+    // Objects retired into the queue may be used by the frame being recorded
+    // and all the previous ones
+    DeferredDestructionQueue & GetDestructionQueue() {
+      return DestructionQueue;
+    }
+
+    FrameLoop( FrameLoop const & ) = delete;
+    FrameLoop& operator=( FrameLoop const & ) = delete;
+
+  private:
+    void ReleaseRetiredObjects();
+    // Keeps the frame reusable after a failure that follows the acquire
+    bool SubmitEmptyFrame( FrameResources          & frame,
+                           WaitSemaphoreInfo const & wait_semaphore_info );
+
+    DeviceDispatch const        * Dispatch;
+    VkQueue                       GraphicsQueue;
+    VkQueue                       PresentQueue;
+    // Swapchain images are shared by both families when they differ
+    std::vector<uint32_t>         QueueFamilies;
+    SubmitBatcher               * Batcher;
+    VkDestroyer(VkCommandPool)    CommandPool;
+    std::vector<FrameResources>   Frames;
+    uint64_t                      FrameIndex;
+    bool                          SwapchainOutOfDate;
+    std::vector<RetiredSwapchain> RetiredSwapchains;
+    // Frame N completes value N + 1
+    DeferredDestructionQueue      DestructionQueue;
+  };
+
+} // namespace VulkanCookbook
+
+#endif // FRAME_LOOP
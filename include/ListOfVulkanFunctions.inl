@@ -51,6 +51,16 @@ GLOBAL_LEVEL_VULKAN_FUNCTION( vkCreateInstance )
 
 #undef GLOBAL_LEVEL_VULKAN_FUNCTION
 
+// Global-level functions added by newer API versions, left null by older loaders
+
+#ifndef GLOBAL_LEVEL_VULKAN_FUNCTION_FROM_VERSION
+#define GLOBAL_LEVEL_VULKAN_FUNCTION_FROM_VERSION( function, version )
+#endif
+
+GLOBAL_LEVEL_VULKAN_FUNCTION_FROM_VERSION( vkEnumerateInstanceVersion, VK_API_VERSION_1_1 )
+
+#undef GLOBAL_LEVEL_VULKAN_FUNCTION_FROM_VERSION
+
 //
 
 #ifndef INSTANCE_LEVEL_VULKAN_FUNCTION
@@ -93,6 +103,16 @@ INSTANCE_LEVEL_VULKAN_FUNCTION_FROM_EXTENSION( vkCreateXlibSurfaceKHR, VK_KHR_XL
 
 #undef INSTANCE_LEVEL_VULKAN_FUNCTION_FROM_EXTENSION
 
+// Instance-level functions added by newer API versions, left null when the instance is older
+
+#ifndef INSTANCE_LEVEL_VULKAN_FUNCTION_FROM_VERSION
+#define INSTANCE_LEVEL_VULKAN_FUNCTION_FROM_VERSION( function, version )
+#endif
+
+INSTANCE_LEVEL_VULKAN_FUNCTION_FROM_VERSION( vkGetPhysicalDeviceProperties2, VK_API_VERSION_1_1 )
+
+#undef INSTANCE_LEVEL_VULKAN_FUNCTION_FROM_VERSION
+
 //
 
 #ifndef DEVICE_LEVEL_VULKAN_FUNCTION
@@ -113,6 +133,7 @@ DEVICE_LEVEL_VULKAN_FUNCTION( vkBindImageMemory )
 DEVICE_LEVEL_VULKAN_FUNCTION( vkCreateImageView )
 DEVICE_LEVEL_VULKAN_FUNCTION( vkMapMemory )
 DEVICE_LEVEL_VULKAN_FUNCTION( vkFlushMappedMemoryRanges )
+DEVICE_LEVEL_VULKAN_FUNCTION( vkInvalidateMappedMemoryRanges )
 DEVICE_LEVEL_VULKAN_FUNCTION( vkUnmapMemory )
 DEVICE_LEVEL_VULKAN_FUNCTION( vkCmdCopyBuffer )
 DEVICE_LEVEL_VULKAN_FUNCTION( vkCmdCopyBufferToImage )
@@ -129,6 +150,7 @@ DEVICE_LEVEL_VULKAN_FUNCTION( vkAllocateCommandBuffers )
 DEVICE_LEVEL_VULKAN_FUNCTION( vkCreateSemaphore )
 DEVICE_LEVEL_VULKAN_FUNCTION( vkCreateFence )
 DEVICE_LEVEL_VULKAN_FUNCTION( vkWaitForFences )
+DEVICE_LEVEL_VULKAN_FUNCTION( vkGetFenceStatus )
 DEVICE_LEVEL_VULKAN_FUNCTION( vkResetFences )
 DEVICE_LEVEL_VULKAN_FUNCTION( vkDestroyFence )
 DEVICE_LEVEL_VULKAN_FUNCTION( vkDestroySemaphore )
@@ -203,3 +225,20 @@ DEVICE_LEVEL_VULKAN_FUNCTION_FROM_EXTENSION( vkQueuePresentKHR, VK_KHR_SWAPCHAIN
 DEVICE_LEVEL_VULKAN_FUNCTION_FROM_EXTENSION( vkDestroySwapchainKHR, VK_KHR_SWAPCHAIN_EXTENSION_NAME )
 
 #undef DEVICE_LEVEL_VULKAN_FUNCTION_FROM_EXTENSION
+
+// Device-level functions promoted to core: loaded by their core name when the
+// negotiated API version is high enough, otherwise by the extension alias
+// when that extension is enabled, otherwise left null
+
+#ifndef DEVICE_LEVEL_VULKAN_FUNCTION_FROM_VERSION
+#define DEVICE_LEVEL_VULKAN_FUNCTION_FROM_VERSION( function, version, extension, extension_function )
+#endif
+
+DEVICE_LEVEL_VULKAN_FUNCTION_FROM_VERSION( vkGetSemaphoreCounterValue, VK_API_VERSION_1_2, VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME, vkGetSemaphoreCounterValueKHR )
+DEVICE_LEVEL_VULKAN_FUNCTION_FROM_VERSION( vkWaitSemaphores, VK_API_VERSION_1_2, VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME, vkWaitSemaphoresKHR )
+DEVICE_LEVEL_VULKAN_FUNCTION_FROM_VERSION( vkSignalSemaphore, VK_API_VERSION_1_2, VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME, vkSignalSemaphoreKHR )
+DEVICE_LEVEL_VULKAN_FUNCTION_FROM_VERSION( vkGetBufferDeviceAddress, VK_API_VERSION_1_2, VK_KHR_BUFFER_DEVICE_ADDRESS_EXTENSION_NAME, vkGetBufferDeviceAddressKHR )
+DEVICE_LEVEL_VULKAN_FUNCTION_FROM_VERSION( vkCmdPipelineBarrier2, VK_API_VERSION_1_3, VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME, vkCmdPipelineBarrier2KHR )
+DEVICE_LEVEL_VULKAN_FUNCTION_FROM_VERSION( vkQueueSubmit2, VK_API_VERSION_1_3, VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME, vkQueueSubmit2KHR )
+
+#undef DEVICE_LEVEL_VULKAN_FUNCTION_FROM_VERSION
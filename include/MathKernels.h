@@ -0,0 +1,98 @@
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Math Kernels
+
+#ifndef MATH_KERNELS
+#define MATH_KERNELS
+
+#include "Common.h"
+#include "ThreadPool.h"
+#include "Tools.h"
+
+namespace VulkanCookbook {
+
+  // Batch versions of the Tools.h operators. The best instruction set supported
+  // by the CPU is selected on first use. Every implementation performs the same
+  // floating point operations in the same order as the scalar operators, so
+  // results are bit-identical across instruction sets.
+  enum class MathKernelSet {
+    Scalar,
+    SSE,
+    AVX2
+  };
+
+  MathKernelSet GetMathKernelSet();
+
+  char const * GetMathKernelSetName( MathKernelSet kernel_set );
+
+  // Returns false (and keeps the current set) when the CPU does not support the requested one
+  bool SetMathKernelSet( MathKernelSet kernel_set );
+
+  // results[i] = left * rights[i]
+  void MultiplyMatrices( Matrix4x4 const & left,
+                         Matrix4x4 const * rights,
+                         Matrix4x4       * results,
+                         size_t            count );
+
+  // results[i] = vectors[i] * matrix; vectors and results may be the same array
+  void TransformVectors( Matrix4x4 const & matrix,
+                         Vector3 const   * vectors,
+                         Vector3         * results,
+                         size_t            count );
+
+  // results[i] = Normalize( vectors[i] ); vectors and results may be the same array
+  void NormalizeVectors( Vector3 const * vectors,
+                         Vector3       * results,
+                         size_t          count );
+
+  // Transforms points stored as separate x, y, z arrays (structure of arrays):
+  // result = matrix * ( x, y, z, 1 ), with the column-major convention used by
+  // shaders. The w component is stored only when result_ws is not null (e.g.
+  // for clip space culling). Results may be written over the inputs.
+  void TransformPositionsSoA( Matrix4x4 const & matrix,
+                              float const     * xs,
+                              float const     * ys,
+                              float const     * zs,
+                              float           * result_xs,
+                              float           * result_ys,
+                              float           * result_zs,
+                              float           * result_ws,
+                              size_t            count );
+
+  // Same as above with the streams split into chunks executed on the thread pool.
+  // Blocks until all chunks are done, so it must not be called from a task of the same pool
+  void TransformPositionsSoA( ThreadPool      & thread_pool,
+                              Matrix4x4 const & matrix,
+                              float const     * xs,
+                              float const     * ys,
+                              float const     * zs,
+                              float           * result_xs,
+                              float           * result_ys,
+                              float           * result_zs,
+                              float           * result_ws,
+                              size_t            count );
+
+  // Compares every available kernel set against the scalar operators and prints the results
+  void BenchmarkMathKernels();
+
+} // namespace VulkanCookbook
+
+#endif // MATH_KERNELS
@@ -0,0 +1,162 @@
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Memory Allocator
+
+#ifndef MEMORY_ALLOCATOR
+#define MEMORY_ALLOCATOR
+
+#include <mutex>
+#include "Common.h"
+
+namespace VulkanCookbook {
+
+  // Buffers and linear images never share a block with optimal-tiling images,
+  // so bufferImageGranularity never has to be padded inside a block
+  enum class MemoryResourceKind {
+    Linear,
+    Optimal
+  };
+
+  struct MemoryBlock;
+
+  struct DeviceMemoryAllocation {
+    VkDeviceMemory    Memory;
+    VkDeviceSize      Offset;
+    VkDeviceSize      Size;
+    void            * Data;         // nullptr unless the memory type is host visible
+    uint32_t          MemoryType;
+    MemoryBlock     * Block;        // nullptr for dedicated allocations
+    uint32_t          Level;
+  };
+
+  using MemoryAllocation = DeviceMemoryAllocation *;
+
+  struct MemoryAllocatorStatistics {
+    uint32_t      DeviceMemoryObjectCount;
+    uint32_t      AllocationCount;
+    VkDeviceSize  ReservedBytes;
+    VkDeviceSize  UsedBytes;
+  };
+
+  // Sub-allocates buffers and images from large per-memory-type blocks.
+  // Every block is managed by a buddy allocator; requests bigger than half
+  // a block get a dedicated vkAllocateMemory call. Host visible blocks stay
+  // persistently mapped for the whole lifetime of the block.
+  class DeviceMemoryAllocator {
+  public:
+    static constexpr VkDeviceSize DefaultBlockSize = 64 * 1024 * 1024;
+    static constexpr VkDeviceSize MinimalNodeSize = 256;
+
+    DeviceMemoryAllocator();
+    ~DeviceMemoryAllocator();
+
+    bool Initialize( VkPhysicalDevice       physical_device,
+                     DeviceDispatch const & dispatch,
+                     VkDeviceSize           block_size = DefaultBlockSize );
+    void Destroy();
+
+    bool Allocate( VkMemoryRequirements const & memory_requirements,
+                   VkMemoryPropertyFlags        memory_properties,
+                   MemoryResourceKind           kind,
+                   MemoryAllocation           & allocation );
+    void Free( MemoryAllocation allocation );
+
+    bool FlushMappedRange( MemoryAllocation allocation,
+                           VkDeviceSize     offset = 0,
+                           VkDeviceSize     size = VK_WHOLE_SIZE );
+    bool InvalidateMappedRange( MemoryAllocation allocation,
+                                VkDeviceSize     offset = 0,
+                                VkDeviceSize     size = VK_WHOLE_SIZE );
+
+    MemoryAllocatorStatistics GetStatistics();
+
+    DeviceDispatch const & GetDispatch() const {
+      return *Dispatch;
+    }
+
+    VkPhysicalDeviceMemoryProperties const & GetMemoryProperties() const {
+      return MemoryProperties;
+    }
+
+    DeviceMemoryAllocator( DeviceMemoryAllocator const & ) = delete;
+    DeviceMemoryAllocator& operator=( DeviceMemoryAllocator const & ) = delete;
+
+  private:
+    bool AllocateFromType( VkMemoryRequirements const & memory_requirements,
+                           uint32_t                     memory_type,
+                           MemoryResourceKind           kind,
+                           MemoryAllocation           & allocation );
+    bool AllocateDedicated( VkMemoryRequirements const & memory_requirements,
+                            uint32_t                     memory_type,
+                            MemoryAllocation           & allocation );
+    bool AllocateMemoryObject( uint32_t          memory_type,
+                               VkDeviceSize      size,
+                               VkDeviceMemory  & memory,
+                               unsigned char  *& data );
+    bool CreateBlock( uint32_t             memory_type,
+                      MemoryResourceKind   kind,
+                      VkDeviceSize         size,
+                      MemoryBlock       *& block );
+    void ReleaseBlock( MemoryBlock * block );
+    bool SyncMappedRange( MemoryAllocation allocation,
+                          VkDeviceSize     offset,
+                          VkDeviceSize     size,
+                          bool             flush );
+
+    DeviceDispatch const                            * Dispatch;
+    VkPhysicalDeviceMemoryProperties                  MemoryProperties;
+    VkDeviceSize                                      NonCoherentAtomSize;
+    VkDeviceSize                                      BlockSize;
+    std::vector<std::unique_ptr<MemoryBlock>>         Blocks;
+    uint32_t                                          DedicatedAllocationCount;
+    uint32_t                                          AllocationCount;
+    std::mutex                                        Mutex;
+  };
+
+  // VkDestroyer<> support for allocations
+
+  struct MemoryAllocationWrapper {
+    MemoryAllocation Handle;
+  };
+
+  template<>
+  inline void DestroyVulkanObject<DeviceMemoryAllocator *, MemoryAllocationWrapper>( DeviceMemoryAllocator * allocator, MemoryAllocationWrapper allocation ) {
+    allocator->Free( allocation.Handle );
+  }
+
+  inline void InitVkDestroyer( DeviceMemoryAllocator & allocator, VkDestroyer<MemoryAllocationWrapper> & destroyer ) {
+    destroyer = VkDestroyer<MemoryAllocationWrapper>( std::bind( DestroyVulkanObject<DeviceMemoryAllocator *, MemoryAllocationWrapper>, &allocator, std::placeholders::_1 ) );
+  }
+
+  bool AllocateAndBindMemoryObjectToBuffer( DeviceMemoryAllocator           & allocator,
+                                            VkBuffer                          buffer,
+                                            VkMemoryPropertyFlags             memory_properties,
+                                            VkDestroyer( MemoryAllocation ) & allocation );
+
+  bool AllocateAndBindMemoryObjectToImage( DeviceMemoryAllocator           & allocator,
+                                           VkImage                           image,
+                                           VkMemoryPropertyFlags             memory_properties,
+                                           VkImageTiling                     tiling,
+                                           VkDestroyer( MemoryAllocation ) & allocation );
+
+} // namespace VulkanCookbook
+
+#endif // MEMORY_ALLOCATOR
@@ -0,0 +1,101 @@
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Mesh Cache
+
+#ifndef MESH_CACHE
+#define MESH_CACHE
+
+#include "Common.h"
+#include "MeshLoader.h"
+#include "Tools.h"
+
+namespace VulkanCookbook {
+
+  // 24 bytes instead of the 32 of InterleavedMesh vertices
+  struct PackedVertex {
+    static constexpr VkFormat PositionFormat = VK_FORMAT_R32G32B32_SFLOAT;
+    static constexpr VkFormat NormalFormat = VK_FORMAT_R16G16B16A16_SNORM;
+    static constexpr VkFormat TexcoordFormat = VK_FORMAT_R16G16_SFLOAT;
+
+    float       Position[3];
+    int16_t     Normal[4];      // w is always zero
+    uint16_t    Texcoord[2];    // half floats
+  };
+
+  struct OptimizedMesh {
+    std::vector<PackedVertex>   Vertices;
+    std::vector<uint32_t>       Indices;
+    bool                        HasNormals;
+    bool                        HasTexcoords;
+  };
+
+  // Quantizes and deduplicates vertices, orders triangles for the post-transform
+  // vertex cache (Forsyth) and then vertices in the order of their first use
+  void OptimizeMesh( InterleavedMesh const & mesh,
+                     OptimizedMesh         & optimized_mesh );
+
+  // The source size and modification time are stored to detect stale caches
+  bool SaveMeshCache( std::string const   & filename,
+                      OptimizedMesh const & mesh,
+                      uint64_t              source_size,
+                      int64_t               source_modification_time );
+
+  struct MeshCacheHeader;
+
+  // Memory mapped cache file. Index data directly follows vertex data, so
+  // GetData() can be uploaded into a single buffer with one copy.
+  class CachedMesh {
+  public:
+    CachedMesh();
+
+    // Fails when the file is missing, damaged or does not match the source
+    bool Open( std::string const & filename,
+               uint64_t            source_size,
+               int64_t             source_modification_time );
+    void Close();
+
+    uint32_t GetVertexCount() const;
+    uint32_t GetIndexCount() const;
+    VkIndexType GetIndexType() const;
+    bool HasNormals() const;
+    bool HasTexcoords() const;
+
+    void const * GetData() const;
+    VkDeviceSize GetDataSize() const;
+    VkDeviceSize GetIndexDataOffset() const;    // relative to GetData()
+
+    CachedMesh( CachedMesh const & ) = delete;
+    CachedMesh& operator=( CachedMesh const & ) = delete;
+
+  private:
+    MappedFile                File;
+    MeshCacheHeader const   * Header;
+  };
+
+  // Opens "<obj_filename>.meshcache", converting the .obj file first when the
+  // cache does not exist or is older than the source
+  bool LoadMeshWithCache( std::string const & obj_filename,
+                          ThreadPool        & thread_pool,
+                          CachedMesh        & mesh );
+
+} // namespace VulkanCookbook
+
+#endif // MESH_CACHE
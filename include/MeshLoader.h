@@ -0,0 +1,55 @@
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Mesh Loader
+
+#ifndef MESH_LOADER
+#define MESH_LOADER
+
+#include "Common.h"
+#include "ThreadPool.h"
+
+namespace VulkanCookbook {
+
+  // Vertices are interleaved as position (3 floats), normal (3 floats) and
+  // texture coordinates (2 floats). Missing attributes are zero.
+  struct InterleavedMesh {
+    static constexpr uint32_t VertexStride = 8;
+
+    std::vector<float>      Vertices;
+    std::vector<uint32_t>   Indices;
+    bool                    HasNormals;
+    bool                    HasTexcoords;
+  };
+
+  // Memory maps the .obj file and parses chunks of it on the thread pool.
+  // Polygons are triangulated as fans; groups, objects and materials are
+  // ignored. When every face corner uses the same index for its position,
+  // normal and texture coordinates (or omits them), vertices correspond to
+  // the "v" lines of the file. Otherwise each corner gets its own vertex.
+  //
+  // Must not be called from a task running on thread_pool.
+  bool LoadInterleavedMeshFromObjFile( std::string const & filename,
+                                       ThreadPool        & thread_pool,
+                                       InterleavedMesh   & mesh );
+
+} // namespace VulkanCookbook
+
+#endif // MESH_LOADER
@@ -0,0 +1,66 @@
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Offscreen Rendering
+
+#ifndef OFFSCREEN
+#define OFFSCREEN
+
+#include "Common.h"
+#include "MemoryAllocator.h"
+
+namespace VulkanCookbook {
+
+  // Color image rendered without any window system, together with a host
+  // visible buffer its contents are copied to after every frame
+  struct OffscreenRenderTarget {
+    VkDestroyer(MemoryAllocation)   ImageMemory;
+    VkDestroyer(VkImage)            Image;
+    VkDestroyer(MemoryAllocation)   ReadbackMemory;
+    VkDestroyer(VkBuffer)           ReadbackBuffer;
+    VkFormat                        Format;
+    VkExtent2D                      Size;
+  };
+
+  // Only formats with four 8-bit components are supported by the readback
+  bool CreateOffscreenRenderTarget( DeviceDispatch const  & dispatch,
+                                    DeviceMemoryAllocator & allocator,
+                                    VkFormat                format,
+                                    VkExtent2D              size,
+                                    OffscreenRenderTarget & render_target );
+
+  // Transitions the image for rendering, calls record_commands, then copies
+  // the image into the readback buffer
+  void RecordOffscreenFrame( DeviceDispatch const                            & dispatch,
+                             VkCommandBuffer                                   command_buffer,
+                             OffscreenRenderTarget                           & render_target,
+                             std::function<void( VkCommandBuffer, VkImage )>   record_commands );
+
+  bool ReadOffscreenRenderTarget( DeviceMemoryAllocator      & allocator,
+                                  OffscreenRenderTarget      & render_target,
+                                  std::vector<unsigned char> & pixels );
+
+  bool SaveImageAsPpm( std::string const                & filename,
+                       VkExtent2D                         size,
+                       std::vector<unsigned char> const & rgba_pixels );
+
+} // namespace VulkanCookbook
+
+#endif // OFFSCREEN
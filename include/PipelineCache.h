@@ -0,0 +1,63 @@
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Pipeline Cache
+
+#ifndef PIPELINE_CACHE
+#define PIPELINE_CACHE
+
+#include "Common.h"
+#include "Tools.h"
+
+namespace VulkanCookbook {
+
+  bool CreatePipelineCacheObject( DeviceDispatch const & dispatch,
+                                  ByteSpan               cache_data,
+                                  VkPipelineCache      & pipeline_cache );
+
+  bool RetrieveDataFromPipelineCache( DeviceDispatch const       & dispatch,
+                                      VkPipelineCache              pipeline_cache,
+                                      std::vector<unsigned char> & pipeline_cache_data );
+
+  bool MergeMultiplePipelineCacheObjects( DeviceDispatch const               & dispatch,
+                                          VkPipelineCache                      target_pipeline_cache,
+                                          std::vector<VkPipelineCache> const & source_pipeline_caches );
+
+  // Checks the VK_PIPELINE_CACHE_HEADER_VERSION_ONE header against the device,
+  // drivers silently ignore (or worse) data produced by a different GPU or driver
+  bool IsPipelineCacheDataCompatible( ByteSpan                           cache_data,
+                                      VkPhysicalDeviceProperties const & device_properties );
+
+  // Creates a pipeline cache seeded from a file written by a previous run.
+  // A missing or incompatible file yields an empty (but valid) cache.
+  bool LoadPipelineCacheFromFile( DeviceDispatch const             & dispatch,
+                                  VkPhysicalDeviceProperties const & device_properties,
+                                  std::string const                & filename,
+                                  VkPipelineCache                  & pipeline_cache );
+
+  // Writes to a temporary file first and renames it over the target, so
+  // a crash mid-write never leaves a truncated cache behind
+  bool SavePipelineCacheToFile( DeviceDispatch const & dispatch,
+                                VkPipelineCache        pipeline_cache,
+                                std::string const    & filename );
+
+} // namespace VulkanCookbook
+
+#endif // PIPELINE_CACHE
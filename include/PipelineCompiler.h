@@ -0,0 +1,70 @@
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Pipeline Compiler
+
+#ifndef PIPELINE_COMPILER
+#define PIPELINE_COMPILER
+
+#include "ThreadPool.h"
+
+namespace VulkanCookbook {
+
+  // Compiles pipelines on a pool of worker threads. Each worker owns a
+  // pipeline cache seeded from the master cache, so workers never contend
+  // on a single cache; Finish() merges them back into the master cache.
+  //
+  // A create info (and everything it points to) must stay valid until the
+  // returned future is ready. A failed compilation, or one requested before
+  // Initialize() or after Finish(), yields VK_NULL_HANDLE.
+  // The caller owns the created pipelines.
+  class PipelineCompiler {
+  public:
+    PipelineCompiler();
+    ~PipelineCompiler();
+
+    bool Initialize( DeviceDispatch const & dispatch,
+                     VkPipelineCache        master_pipeline_cache,
+                     uint32_t               thread_count = 0 );
+
+    std::shared_future<VkPipeline> CompileGraphicsPipeline( VkGraphicsPipelineCreateInfo const & create_info );
+    std::shared_future<VkPipeline> CompileComputePipeline( VkComputePipelineCreateInfo const & create_info );
+
+    // Waits for outstanding compilations and merges per-thread caches into the master cache
+    bool Finish();
+
+    PipelineCompiler( PipelineCompiler const & ) = delete;
+    PipelineCompiler& operator=( PipelineCompiler const & ) = delete;
+
+  private:
+    DeviceDispatch const          * Dispatch;
+    VkPipelineCache                 MasterPipelineCache;
+    std::vector<VkPipelineCache>    WorkerPipelineCaches;
+    std::unique_ptr<ThreadPool>     Workers;
+  };
+
+  inline bool IsPipelineReady( std::shared_future<VkPipeline> const & pipeline ) {
+    return pipeline.valid() &&
+           (std::future_status::ready == pipeline.wait_for( std::chrono::seconds( 0 ) ));
+  }
+
+} // namespace VulkanCookbook
+
+#endif // PIPELINE_COMPILER
@@ -0,0 +1,61 @@
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Present Policy
+
+#ifndef PRESENT_POLICY
+#define PRESENT_POLICY
+
+#include "Common.h"
+
+namespace VulkanCookbook {
+
+  // LowLatency  - MAILBOX or IMMEDIATE with as few images as possible; the default
+  //               number of frames in flight keeps the CPU and the GPU overlapped
+  // Throughput  - FIFO with a deeper image queue, so the GPU never waits for the CPU
+  // PowerSave   - FIFO_RELAXED, rendering never runs ahead of the display
+  enum class PresentProfile {
+    LowLatency,
+    Throughput,
+    PowerSave
+  };
+
+  bool ParsePresentProfile( char const     * name,
+                            PresentProfile & profile );
+
+  char const * GetPresentProfileName( PresentProfile profile );
+
+  // Picks the first mode of the profile's preference list that the surface supports;
+  // FIFO is the last resort, as it is always available
+  bool SelectPresentModeForProfile( VkPhysicalDevice   physical_device,
+                                    VkSurfaceKHR       presentation_surface,
+                                    PresentProfile     profile,
+                                    VkPresentModeKHR & present_mode );
+
+  bool SelectNumberOfSwapchainImagesForProfile( VkSurfaceCapabilitiesKHR const & surface_capabilities,
+                                                PresentProfile                   profile,
+                                                VkPresentModeKHR                 present_mode,
+                                                uint32_t                       & number_of_images );
+
+  uint32_t GetFramesInFlightForProfile( PresentProfile profile );
+
+} // namespace VulkanCookbook
+
+#endif // PRESENT_POLICY
@@ -0,0 +1,76 @@
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Queue Selection
+
+#ifndef QUEUE_SELECTION
+#define QUEUE_SELECTION
+
+#include "Common.h"
+
+namespace VulkanCookbook {
+
+  struct QueueAssignment {
+    uint32_t    FamilyIndex;
+    uint32_t    QueueIndex;
+  };
+
+  struct QueueFamilyRequest {
+    uint32_t    FamilyIndex;
+    uint32_t    QueueCount;
+  };
+
+  // Compute and transfer prefer families without graphics (and, for transfer,
+  // without compute) support, so work submitted to them runs asynchronously.
+  // Roles sharing a family get separate queues while the family has enough.
+  struct QueueLayout {
+    QueueAssignment                   Graphics;
+    QueueAssignment                   Compute;
+    QueueAssignment                   Transfer;
+    QueueAssignment                   Present;
+    std::vector<QueueFamilyRequest>   Requests;
+  };
+
+  struct DeviceQueues {
+    VkQueue   Graphics;
+    VkQueue   Compute;
+    VkQueue   Transfer;
+    VkQueue   Present;
+  };
+
+  // Returns the family providing desired_capabilities with the fewest of the
+  // undesired_capabilities; graphics and compute families count as transfer capable
+  bool SelectPreferredQueueFamily( std::vector<VkQueueFamilyProperties> const & queue_families,
+                                   VkQueueFlags                                 desired_capabilities,
+                                   VkQueueFlags                                 undesired_capabilities,
+                                   uint32_t                                   & queue_family_index );
+
+  // presentation_surface may be VK_NULL_HANDLE, Present then mirrors Graphics
+  bool SelectQueueLayout( VkPhysicalDevice   physical_device,
+                          VkSurfaceKHR       presentation_surface,
+                          QueueLayout      & queue_layout );
+
+  void GetDeviceQueues( DeviceDispatch const & dispatch,
+                        QueueLayout const    & queue_layout,
+                        DeviceQueues         & queues );
+
+} // namespace VulkanCookbook
+
+#endif // QUEUE_SELECTION
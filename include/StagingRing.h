@@ -0,0 +1,143 @@
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Staging Ring
+
+#ifndef STAGING_RING
+#define STAGING_RING
+
+#include <deque>
+#include "Common.h"
+#include "MemoryAllocator.h"
+#include "SubmitBatcher.h"
+#include "FencePool.h"
+
+namespace VulkanCookbook {
+
+  struct StagingBatch {
+    VkCommandBuffer           CommandBuffer;
+    uint64_t                  SubmissionId;
+    bool                      Complete;
+    uint64_t                  Id;
+    uint64_t                  Begin;
+    uint64_t                  End;
+  };
+
+  // Persistently mapped upload buffer used as a ring. Data is copied into the
+  // ring immediately, while the copy commands are collected in the current
+  // batch and submitted to the transfer queue together by Flush(). Ring space
+  // of a batch is reused once the completion tracker reports its submission
+  // as complete - the tracker has to outlive the ring. Not thread safe.
+  //
+  // With a submit batcher, batches are added to it instead of being submitted
+  // directly, so they share a vkQueueSubmit with the other work of the frame.
+  //
+  // Offsets are virtual - they only grow, the ring position is offset % size.
+  class StagingRing {
+  public:
+    static constexpr VkDeviceSize DefaultSize = 32 * 1024 * 1024;
+    static constexpr uint32_t     DefaultBatchCount = 3;
+    static constexpr VkDeviceSize DefaultAlignment = 16;
+
+    StagingRing();
+    ~StagingRing();
+
+    bool Initialize( DeviceDispatch const  & dispatch,
+                     DeviceMemoryAllocator & allocator,
+                     CompletionTracker     & completion_tracker,
+                     uint32_t                transfer_queue_family,
+                     VkQueue                 transfer_queue,
+                     VkDeviceSize            size = DefaultSize,
+                     uint32_t                batch_count = DefaultBatchCount,
+                     SubmitBatcher         * submit_batcher = nullptr );
+    void Destroy();
+
+    // When destination_queue_family differs from the transfer family, ownership
+    // is released to it - the consumer has to record the matching acquire barrier
+    bool UploadToBuffer( void const   * data,
+                         VkDeviceSize   size,
+                         VkBuffer       destination_buffer,
+                         VkDeviceSize   destination_offset,
+                         uint32_t       destination_queue_family = VK_QUEUE_FAMILY_IGNORED );
+
+    // The subresource is transitioned from VK_IMAGE_LAYOUT_UNDEFINED, so previous contents are lost
+    bool UploadToImage( void const               * data,
+                        VkDeviceSize               size,
+                        VkImage                    destination_image,
+                        VkImageSubresourceLayers   subresource,
+                        VkOffset3D                 image_offset,
+                        VkExtent3D                 image_extent,
+                        VkImageLayout              final_layout,
+                        uint32_t                   destination_queue_family = VK_QUEUE_FAMILY_IGNORED );
+
+    // Submits everything uploaded since the last call with a single vkQueueSubmit,
+    // or adds it to the submit batcher, which submits it when flushed
+    bool Flush( std::vector<VkSemaphore> const & signal_semaphores = {} );
+
+    // Id of the batch which the next uploads are recorded into. A batch without
+    // uploads is never submitted, so query it after recording at least one
+    uint64_t GetRecordingBatchId() const {
+      return NextBatchId;
+    }
+
+    // Polls the completion tracker without blocking
+    bool IsBatchComplete( uint64_t batch_id );
+
+    bool WaitIdle();
+
+    VkDeviceSize GetSize() const {
+      return Size;
+    }
+
+    StagingRing( StagingRing const & ) = delete;
+    StagingRing& operator=( StagingRing const & ) = delete;
+
+  private:
+    bool Allocate( VkDeviceSize     size,
+                   VkDeviceSize     alignment,
+                   VkDeviceSize   & ring_offset );
+    bool BeginBatch();
+    bool RetireOldestBatch();
+    void RetireCompletedBatches();
+
+    DeviceDispatch const            * Dispatch;
+    DeviceMemoryAllocator           * Allocator;
+    CompletionTracker               * Tracker;
+    uint32_t                          TransferQueueFamily;
+    VkQueue                           TransferQueue;
+    SubmitBatcher                   * Batcher;
+    VkDeviceSize                      Size;
+    VkDestroyer(MemoryAllocation)     BufferMemory;
+    VkDestroyer(VkBuffer)             Buffer;
+    unsigned char                   * Data;
+    VkDestroyer(VkCommandPool)        CommandPool;
+    std::vector<StagingBatch>         Batches;
+    std::deque<uint32_t>              SubmittedBatches;
+    uint32_t                          RecordingBatch;
+    bool                              Recording;
+    uint64_t                          Head;
+    uint64_t                          Tail;
+    uint64_t                          NextBatchId;
+    uint64_t                          CompletedBatchId;
+  };
+
+} // namespace VulkanCookbook
+
+#endif // STAGING_RING
@@ -0,0 +1,128 @@
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Submit Batcher
+
+#ifndef SUBMIT_BATCHER
+#define SUBMIT_BATCHER
+
+#include <mutex>
+#include "Common.h"
+
+namespace VulkanCookbook {
+
+  // Value is used only for timeline semaphores
+  struct SemaphoreWaitInfo {
+    VkSemaphore             Semaphore;
+    uint64_t                Value;
+    VkPipelineStageFlags    WaitingStage;
+  };
+
+  struct SemaphoreSignalInfo {
+    VkSemaphore   Semaphore;
+    uint64_t      Value;
+  };
+
+  struct SubmitBatch {
+    std::vector<SemaphoreWaitInfo>    WaitSemaphores;
+    std::vector<VkCommandBuffer>      CommandBuffers;
+    std::vector<SemaphoreSignalInfo>  SignalSemaphores;
+  };
+
+  struct SubmitBatcherStatistics {
+    uint64_t    Batches;
+    uint64_t    SubmitInfos;
+    uint64_t    QueueSubmits;
+    uint64_t    FenceSubmits;   // vkQueueSubmit without batches, for additional fences
+  };
+
+  // Submits all batches with a single vkQueueSubmit. Consecutive batches are
+  // merged into one VkSubmitInfo when that delays nothing - the merged batch
+  // may only wait before its first and signal after its last command buffer.
+  // Waits on the same semaphore are merged (the latest timeline value, all stages)
+  bool SubmitBatchesToQueue( DeviceDispatch const           & dispatch,
+                             VkQueue                          queue,
+                             std::vector<SubmitBatch> const & batches,
+                             VkFence                          fence,
+                             uint32_t                       * submit_info_count = nullptr );
+
+  // Collects submissions from many subsystems during a frame and issues one
+  // vkQueueSubmit per queue (see SubmitBatchesToQueue) when flushed.
+  //
+  // Add() can be called from any thread. Queues are flushed in the order they
+  // were first used, so binary semaphores are signaled before the waits of
+  // other queues are submitted, as long as the producers were added first.
+  class SubmitBatcher {
+  public:
+    SubmitBatcher();
+
+    bool Initialize( DeviceDispatch const & dispatch );
+
+    // The fence is signaled once the batch and all the work submitted to the
+    // queue before it have completed, but possibly later than that - it is
+    // submitted together with all the batches of the queue
+    void Add( VkQueue             queue,
+              SubmitBatch const & batch,
+              VkFence             fence = VK_NULL_HANDLE );
+
+    // The fence is signaled when all batches of the queue have completed.
+    // Also submits the fence alone when nothing was added. A queue takes
+    // only one fence per vkQueueSubmit, any other fences are submitted after
+    // the batches without work.
+    //
+    // The fence is submitted together with the batches, fence_submitted tells
+    // whether that succeeded. When the batches fail, the fences given to Add()
+    // are still signaled with empty submissions, so their owners don't wait
+    // forever; the ones that could not be submitted at all are appended to
+    // unsignaled_fences
+    bool Flush( VkQueue                queue,
+                VkFence                fence = VK_NULL_HANDLE,
+                bool                 * fence_submitted = nullptr,
+                std::vector<VkFence> * unsignaled_fences = nullptr );
+
+    // Every queue is flushed even when an earlier one fails, so no batch is
+    // left behind. The fence is submitted with the batches of fence_queue,
+    // which is flushed even when nothing was added to it
+    bool FlushAll( VkQueue                fence_queue = VK_NULL_HANDLE,
+                   VkFence                fence = VK_NULL_HANDLE,
+                   bool                 * fence_submitted = nullptr,
+                   std::vector<VkFence> * unsignaled_fences = nullptr );
+
+    SubmitBatcherStatistics GetStatistics();
+
+    SubmitBatcher( SubmitBatcher const & ) = delete;
+    SubmitBatcher& operator=( SubmitBatcher const & ) = delete;
+
+  private:
+    struct QueueBatches {
+      VkQueue                   Queue;
+      std::vector<SubmitBatch>  Batches;
+      std::vector<VkFence>      Fences;
+    };
+
+    DeviceDispatch const      * Dispatch;
+    std::mutex                  Mutex;
+    std::vector<QueueBatches>   Queues;
+    SubmitBatcherStatistics     Statistics;
+  };
+
+} // namespace VulkanCookbook
+
+#endif // SUBMIT_BATCHER
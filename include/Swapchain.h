@@ -0,0 +1,91 @@
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Swapchain
+
+#ifndef SWAPCHAIN
+#define SWAPCHAIN
+
+#include "Common.h"
+
+namespace VulkanCookbook {
+
+  struct SwapchainState {
+    VkDestroyer(VkSwapchainKHR)             Handle;
+    VkFormat                                Format;
+    VkExtent2D                              Size;
+    std::vector<VkImage>                    Images;
+    std::vector<VkDestroyer(VkImageView)>   ImageViews;
+  };
+
+  bool SelectSizeOfSwapchainImages( VkSurfaceCapabilitiesKHR const & surface_capabilities,
+                                    VkExtent2D                     & size_of_images );
+
+  bool SelectDesiredUsageScenariosOfSwapchainImages( VkSurfaceCapabilitiesKHR const & surface_capabilities,
+                                                     VkImageUsageFlags                desired_usages,
+                                                     VkImageUsageFlags              & image_usage );
+
+  bool SelectTransformationOfSwapchainImages( VkSurfaceCapabilitiesKHR const & surface_capabilities,
+                                              VkSurfaceTransformFlagBitsKHR    desired_transform,
+                                              VkSurfaceTransformFlagBitsKHR  & surface_transform );
+
+  bool SelectFormatOfSwapchainImages( VkPhysicalDevice     physical_device,
+                                      VkSurfaceKHR         presentation_surface,
+                                      VkSurfaceFormatKHR   desired_surface_format,
+                                      VkFormat           & image_format,
+                                      VkColorSpaceKHR    & image_color_space );
+
+  // old_swapchain is only passed to the driver so it can reuse its resources,
+  // destroying it stays the responsibility of the caller. When the queue
+  // families using the images (e.g. graphics and present) differ, the images
+  // are shared concurrently, so no ownership transfers have to be recorded
+  bool CreateSwapchain( DeviceDispatch const          & dispatch,
+                        VkSurfaceKHR                    presentation_surface,
+                        uint32_t                        image_count,
+                        VkSurfaceFormatKHR              surface_format,
+                        VkExtent2D                      image_size,
+                        VkImageUsageFlags               image_usage,
+                        VkSurfaceTransformFlagBitsKHR   surface_transform,
+                        VkPresentModeKHR                present_mode,
+                        VkSwapchainKHR                  old_swapchain,
+                        std::vector<uint32_t> const   & queue_families,
+                        VkSwapchainKHR                & swapchain );
+
+  bool GetHandlesOfSwapchainImages( DeviceDispatch const & dispatch,
+                                    VkSwapchainKHR         swapchain,
+                                    std::vector<VkImage> & swapchain_images );
+
+  // Any swapchain previously held in the swapchain parameter is destroyed, so
+  // move it out first if it is still passed as old_swapchain
+  bool CreateSwapchainWithImageViews( VkPhysicalDevice                physical_device,
+                                      DeviceDispatch const          & dispatch,
+                                      VkSurfaceKHR                    presentation_surface,
+                                      uint32_t                        image_count,
+                                      VkPresentModeKHR                present_mode,
+                                      VkImageUsageFlags               image_usage,
+                                      VkSwapchainKHR                  old_swapchain,
+                                      std::vector<uint32_t> const   & queue_families,
+                                      SwapchainState                & swapchain );
+
+  void DestroySwapchain( SwapchainState & swapchain );
+
+} // namespace VulkanCookbook
+
+#endif // SWAPCHAIN
@@ -0,0 +1,201 @@
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Texture Streamer
+
+#ifndef TEXTURE_STREAMER
+#define TEXTURE_STREAMER
+
+#include <queue>
+#include "Common.h"
+#include "MemoryAllocator.h"
+#include "StagingRing.h"
+#include "ThreadPool.h"
+
+namespace VulkanCookbook {
+
+  using TextureHandle = uint32_t;
+
+  enum class TextureStreamState {
+    Idle,         // nothing to do, the resident image (if any) satisfies the request
+    Queued,       // waiting for a free decoding slot
+    Decoding,     // a worker reads and decodes the file
+    Decoded,      // mip chain is ready, waiting for budget and staging space
+    Uploading,    // copies were recorded into a staging batch
+    Failed
+  };
+
+  struct MipmapLevel {
+    uint32_t                    Width;
+    uint32_t                    Height;
+    std::vector<unsigned char>  Data;     // tightly packed RGBA8
+  };
+
+  struct TextureImage {
+    VkDestroyer(MemoryAllocation)   Memory;
+    VkDestroyer(VkImage)            Image;
+    VkDestroyer(VkImageView)        View;
+    uint32_t                        BaseMip;    // mip of the source image stored in level 0
+    uint32_t                        MipCount;
+    VkDeviceSize                    Bytes;
+  };
+
+  // Ownership of each mip level is released separately, so it is acquired the same way
+  struct PendingAcquire {
+    VkImage     Image;
+    uint32_t    MipCount;
+  };
+
+  struct StreamedTexture {
+    std::string                                       Filename;
+    TextureStreamState                                State;
+    uint32_t                                          RequestedMip;
+    uint32_t                                          FinestMip;      // limited by the staging ring size and the budget
+    uint64_t                                          RequestSerial;
+    uint64_t                                          LastRequestedFrame;
+    std::future<std::vector<MipmapLevel>>             Decoding;
+    std::vector<MipmapLevel>                          Levels;
+    TextureImage                                      Resident;
+    TextureImage                                      Uploading;
+    uint64_t                                          UploadBatchId;
+  };
+
+  struct TextureStreamerStatistics {
+    uint32_t      TextureCount;
+    uint32_t      ResidentCount;
+    uint32_t      PendingCount;
+    VkDeviceSize  ResidentBytes;
+    VkDeviceSize  Budget;
+    uint64_t      EvictionCount;
+  };
+
+  // Streams RGBA8 textures from disk into device local images. Files are
+  // decoded with stb_image on a worker pool and turned into full mip chains
+  // there; the owning thread uploads the results through a staging ring.
+  // Decoding order follows the requested mip level - the most detailed
+  // requests first. Device memory used by textures is kept under a budget by
+  // evicting the least recently requested ones.
+  //
+  // Everything except the decoding runs on the thread calling Update(), so
+  // the class itself is not thread safe. Update() is expected once per frame.
+  // A texture is considered in use by the GPU for retire_delay frames after
+  // it was last requested; only older textures are evicted or destroyed.
+  class TextureStreamer {
+  public:
+    static constexpr VkDeviceSize DefaultBudget = 512 * 1024 * 1024;
+    static constexpr uint32_t     DefaultRetireDelay = 3;
+
+    TextureStreamer();
+    ~TextureStreamer();
+
+    // When consumer_queue_family differs from the queue family of the staging
+    // ring, ownership of uploaded images is released to it and
+    // RecordAcquireBarriers() has to be recorded before the textures are used
+    bool Initialize( DeviceDispatch const  & dispatch,
+                     DeviceMemoryAllocator & allocator,
+                     StagingRing           & staging_ring,
+                     uint32_t                staging_queue_family,
+                     uint32_t                consumer_queue_family,
+                     uint32_t                thread_count = 0,
+                     VkDeviceSize            budget = DefaultBudget,
+                     uint32_t                retire_delay = DefaultRetireDelay );
+    void Destroy();
+
+    TextureHandle RegisterTexture( std::string const & filename );
+
+    // Marks the texture as used in the current frame. mip_level is the most
+    // detailed level needed; requesting a lower level than the resident one
+    // streams the texture again.
+    void RequestTexture( TextureHandle handle,
+                         uint32_t      mip_level = 0 );
+
+    // Returns VK_NULL_HANDLE until the texture is resident. base_mip receives
+    // the mip of the source image stored in the first level of the view.
+    VkImageView GetTextureView( TextureHandle   handle,
+                                uint32_t      * base_mip = nullptr ) const;
+
+    TextureStreamState GetTextureState( TextureHandle handle ) const;
+
+    bool Update();
+
+    // Acquires ownership of textures which became resident since the last call
+    void RecordAcquireBarriers( VkCommandBuffer command_buffer );
+
+    TextureStreamerStatistics GetStatistics() const;
+
+    TextureStreamer( TextureStreamer const & ) = delete;
+    TextureStreamer& operator=( TextureStreamer const & ) = delete;
+
+  private:
+    struct PendingDecode {
+      uint32_t        Mip;
+      uint64_t        Serial;
+      TextureHandle   Handle;
+
+      // std::priority_queue keeps the largest element on top
+      bool operator<( PendingDecode const & other ) const {
+        return (Mip != other.Mip) ? (Mip > other.Mip) : (Serial > other.Serial);
+      }
+    };
+
+    struct RetiredImage {
+      TextureImage    Image;
+      uint64_t        Frame;
+    };
+
+    bool IsRecentlyRequested( StreamedTexture const & texture ) const;
+    void CollectDecodedTextures();
+    void CollectUploadedTextures();
+    void DispatchDecodes();
+    bool UploadDecodedTextures();
+    bool UploadTexture( StreamedTexture & texture,
+                        uint32_t          base_mip );
+    bool MakeRoom( VkDeviceSize bytes );
+    void QueueDecode( TextureHandle handle );
+    void RetireImage( TextureImage & image );
+    void RemovePendingAcquire( VkImage image );
+    void ReleaseRetiredImages();
+
+    DeviceDispatch const                    * Dispatch;
+    DeviceMemoryAllocator                   * Allocator;
+    StagingRing                             * Ring;
+    uint32_t                                  StagingQueueFamily;
+    uint32_t                                  ConsumerQueueFamily;
+    VkDeviceSize                              Budget;
+    uint32_t                                  RetireDelay;
+    std::unique_ptr<ThreadPool>               Workers;
+    uint32_t                                  MaxPendingDecodes;
+    VkDeviceSize                              UploadBytesPerUpdate;
+    std::vector<StreamedTexture>              Textures;
+    std::priority_queue<PendingDecode>        DecodeQueue;
+    std::vector<TextureHandle>                DecodingTextures;
+    std::vector<TextureHandle>                DecodedTextures;
+    std::vector<TextureHandle>                UploadingTextures;
+    std::vector<RetiredImage>                 RetiredImages;
+    std::vector<PendingAcquire>               PendingAcquires;
+    VkDeviceSize                              UsedBytes;
+    uint64_t                                  NextRequestSerial;
+    uint64_t                                  CurrentFrame;
+    uint64_t                                  EvictionCount;
+  };
+
+} // namespace VulkanCookbook
+
+#endif // TEXTURE_STREAMER
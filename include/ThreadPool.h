@@ -0,0 +1,83 @@
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Thread Pool
+
+#ifndef THREAD_POOL
+#define THREAD_POOL
+
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
+#include "Common.h"
+
+namespace VulkanCookbook {
+
+  // Fixed set of worker threads executing tasks in submission order.
+  // Every task receives the index of the worker running it, which lets
+  // callers keep per-thread objects (pipeline caches, command pools, ...)
+  // without any additional locking.
+  class ThreadPool {
+  public:
+    explicit ThreadPool( uint32_t thread_count = 0 );
+    ~ThreadPool();
+
+    uint32_t GetThreadCount() const {
+      return static_cast<uint32_t>(Workers.size());
+    }
+
+    template<class Function>
+    auto Submit( Function && function ) -> std::future<decltype(function( uint32_t() ))> {
+      using ResultType = decltype(function( uint32_t() ));
+
+      auto task = std::make_shared<std::packaged_task<ResultType( uint32_t )>>( std::forward<Function>( function ) );
+      std::future<ResultType> result = task->get_future();
+      {
+        std::lock_guard<std::mutex> lock( Mutex );
+        Tasks.emplace_back( [task]( uint32_t worker_index ) {
+          (*task)( worker_index );
+        } );
+      }
+      TaskAvailable.notify_one();
+      return result;
+    }
+
+    // Blocks until the queue is empty and no task is running
+    void WaitIdle();
+
+    ThreadPool( ThreadPool const & ) = delete;
+    ThreadPool& operator=( ThreadPool const & ) = delete;
+
+  private:
+    void WorkerLoop( uint32_t worker_index );
+
+    std::vector<std::thread>                      Workers;
+    std::deque<std::function<void( uint32_t )>>   Tasks;
+    std::mutex                                    Mutex;
+    std::condition_variable                       TaskAvailable;
+    std::condition_variable                       TasksFinished;
+    uint32_t                                      ActiveTaskCount;
+    bool                                          Stopping;
+  };
+
+} // namespace VulkanCookbook
+
+#endif // THREAD_POOL
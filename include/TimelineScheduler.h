@@ -0,0 +1,125 @@
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Timeline Scheduler
+
+#ifndef TIMELINE_SCHEDULER
+#define TIMELINE_SCHEDULER
+
+#include "Common.h"
+#include "CommandBuffers.h"
+#include "SubmitBatcher.h"
+#include "VulkanPromoted.h"
+
+namespace VulkanCookbook {
+
+  // Timeline semaphores are core in Vulkan 1.2 and need VK_KHR_timeline_semaphore
+  // before. Adds the extension when required and fills the feature structure,
+  // which has to be chained into VkDeviceCreateInfo::pNext. Returns false when
+  // the device supports neither.
+  bool PrepareTimelineSemaphoreFeatures( VkPhysicalDevice                            physical_device,
+                                         std::vector<char const *>                 & desired_extensions,
+                                         VkPhysicalDeviceTimelineSemaphoreFeatures & timeline_semaphore_features );
+
+  bool CreateTimelineSemaphore( DeviceDispatch const & dispatch,
+                                uint64_t               initial_value,
+                                VkSemaphore          & semaphore );
+
+  // A value on the timeline of one of the scheduler's queues
+  struct TimelinePoint {
+    uint32_t    Queue;
+    uint64_t    Value;
+  };
+
+  struct TimelineDependency {
+    TimelinePoint           Point;
+    VkPipelineStageFlags    WaitingStage;
+  };
+
+  struct ScheduledSubmission {
+    std::vector<VkCommandBuffer>      CommandBuffers;
+    std::vector<TimelineDependency>   Dependencies;
+    // Binary semaphores, e.g. for swapchain image acquisition and presentation
+    std::vector<WaitSemaphoreInfo>    WaitSemaphores;
+    std::vector<VkSemaphore>          SignalSemaphores;
+  };
+
+  // Every queue gets a timeline semaphore whose value is incremented by each
+  // submission. Submissions depend on points of other queues' timelines, so
+  // queues run ahead independently and the CPU can wait on any submission
+  // without a fence per submit. Queue indices refer to the vector passed to
+  // Initialize(); indices with the same VkQueue share one timeline, as their
+  // submissions execute in order anyway. Not thread safe.
+  class TimelineScheduler {
+  public:
+    TimelineScheduler();
+    ~TimelineScheduler();
+
+    // The device must be created with the timeline semaphore feature enabled.
+    // With a batcher, submissions are only added to it - flush it before
+    // waiting for them
+    bool Initialize( DeviceDispatch const       & dispatch,
+                     std::vector<VkQueue> const & queues,
+                     SubmitBatcher              * submit_batcher = nullptr );
+    void Destroy();
+
+    // On success submission_point receives the point signaled when the submission completes
+    bool Submit( uint32_t                    queue,
+                 ScheduledSubmission const & submission,
+                 TimelinePoint             & submission_point );
+
+    // Polls the semaphore only when the cached completed value is too old
+    bool IsComplete( TimelinePoint const & point );
+
+    bool Wait( std::vector<TimelinePoint> const & points,
+               bool                               wait_for_all = true,
+               uint64_t                           timeout = UINT64_MAX );
+
+    // Waits for everything submitted to all queues - replaces vkQueueWaitIdle
+    bool WaitIdle( uint64_t timeout = UINT64_MAX );
+
+    uint64_t GetLastSubmittedValue( uint32_t queue ) const;
+    uint64_t GetCompletedValue( uint32_t queue );
+    VkSemaphore GetSemaphore( uint32_t queue ) const;
+
+    TimelineScheduler( TimelineScheduler const & ) = delete;
+    TimelineScheduler& operator=( TimelineScheduler const & ) = delete;
+
+  private:
+    struct Timeline {
+      VkQueue                   Queue;
+      VkDestroyer(VkSemaphore)  Semaphore;
+      uint64_t                  LastSubmittedValue;
+      uint64_t                  CompletedValue;
+    };
+
+    Timeline * GetTimeline( uint32_t queue );
+    Timeline const * GetTimeline( uint32_t queue ) const;
+
+    DeviceDispatch const                  * Dispatch;
+    SubmitBatcher                         * Batcher;
+    std::vector<Timeline>                   Timelines;
+    // Queue index -> index into Timelines
+    std::vector<uint32_t>                   QueueTimelines;
+  };
+
+} // namespace VulkanCookbook
+
+#endif // TIMELINE_SCHEDULER
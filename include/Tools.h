@@ -42,6 +42,91 @@ namespace VulkanCookbook {
   bool GetBinaryFileContents( std::string const          & filename,
                               std::vector<unsigned char> & contents );
 
+  // Non-owning view of bytes
+  struct ByteSpan {
+    ByteSpan() :
+      Data( nullptr ),
+      Size( 0 ) {
+    }
+
+    ByteSpan( unsigned char const * data,
+              size_t                size ) :
+      Data( data ),
+      Size( size ) {
+    }
+
+    ByteSpan( std::vector<unsigned char> const & data ) :
+      Data( data.data() ),
+      Size( data.size() ) {
+    }
+
+    unsigned char const   * Data;
+    size_t                  Size;
+  };
+
+  enum MappedFileHintBits {
+    MAPPED_FILE_HINT_SEQUENTIAL_BIT = 0x00000001,   // MADV_SEQUENTIAL / FILE_FLAG_SEQUENTIAL_SCAN
+    MAPPED_FILE_HINT_POPULATE_BIT   = 0x00000002    // MAP_POPULATE - read the whole file while mapping it
+  };
+  using MappedFileHints = uint32_t;
+
+  // Read-only memory mapping of a whole file. When the file cannot be mapped,
+  // its contents are read into memory instead, so callers always get a view.
+  class MappedFile {
+  public:
+    MappedFile();
+    ~MappedFile();
+
+    bool Open( std::string const & filename,
+               MappedFileHints     hints = MAPPED_FILE_HINT_SEQUENTIAL_BIT );
+    void Close();
+
+    unsigned char const * GetData() const {
+      return Data;
+    }
+
+    size_t GetSize() const {
+      return Size;
+    }
+
+    ByteSpan GetSpan() const {
+      return ByteSpan( Data, Size );
+    }
+
+    bool IsMapped() const {
+      return Mapped;
+    }
+
+    MappedFile( MappedFile const & ) = delete;
+    MappedFile& operator=( MappedFile const & ) = delete;
+
+  private:
+#ifdef _WIN32
+    HANDLE                        File;
+    HANDLE                        Mapping;
+#else
+    int                           FileDescriptor;
+#endif
+    unsigned char const         * Data;
+    size_t                        Size;
+    bool                          Mapped;
+    std::vector<unsigned char>    FallbackContents;
+  };
+
+  // Zero-copy variant - contents stays valid while file is open
+  bool GetBinaryFileContents( std::string const & filename,
+                              MappedFile        & file,
+                              ByteSpan          & contents,
+                              MappedFileHints     hints = MAPPED_FILE_HINT_SEQUENTIAL_BIT );
+
+  // Name for a file written next to target before it replaces the target;
+  // unique per process, so concurrent writers don't share one file
+  std::string GetTemporaryFilename( std::string const & target );
+
+  // Moves a fully written temporary file over target; removes it on failure
+  bool ReplaceFileAtomically( std::string const & temporary,
+                              std::string const & target );
+
   float Deg2Rad( float value );
 
   float Dot( Vector3 const & left,
@@ -74,14 +74,27 @@ namespace VulkanCookbook {
     vkDestroySurfaceKHR( instance, surface.Handle, nullptr );
   }
 
-#define VK_DESTROYER_SPECIALIZATION( VkChild, VkDeleter )                                                   \
-  struct VkChild##Wrapper {                                                                                 \
-    VkChild Handle;                                                                                         \
-  };                                                                                                        \
-                                                                                                            \
-  template<>                                                                                                \
-  inline void DestroyVulkanObject<VkDevice, VkChild##Wrapper>( VkDevice device, VkChild##Wrapper object ) { \
-    VkDeleter( device, object.Handle, nullptr );                                                            \
+  // The table may still be empty when the device is wrapped, as it can only be loaded after creating the device
+  template<>
+  inline void DestroyVulkanObject<DeviceDispatch const *, VkDeviceWrapper>( DeviceDispatch const * dispatch, VkDeviceWrapper object ) {
+    if( nullptr != dispatch->vkDestroyDevice ) {
+      dispatch->vkDestroyDevice( object.Handle, nullptr );
+    }
+  }
+
+#define VK_DESTROYER_SPECIALIZATION( VkChild, VkDeleter )                                                                                 \
+  struct VkChild##Wrapper {                                                                                                               \
+    VkChild Handle;                                                                                                                       \
+  };                                                                                                                                      \
+                                                                                                                                          \
+  template<>                                                                                                                              \
+  inline void DestroyVulkanObject<VkDevice, VkChild##Wrapper>( VkDevice device, VkChild##Wrapper object ) {                               \
+    VkDeleter( device, object.Handle, nullptr );                                                                                          \
+  }                                                                                                                                       \
+                                                                                                                                          \
+  template<>                                                                                                                              \
+  inline void DestroyVulkanObject<DeviceDispatch const *, VkChild##Wrapper>( DeviceDispatch const * dispatch, VkChild##Wrapper object ) { \
+    dispatch->VkDeleter( dispatch->Device, object.Handle, nullptr );                                                                      \
   }
 
   VK_DESTROYER_SPECIALIZATION( VkSemaphore, vkDestroySemaphore )
@@ -202,6 +215,12 @@ namespace VulkanCookbook {
     destroyer = VkDestroyer<VkType>( std::bind( DestroyVulkanObject<decltype(VkParent::Handle), VkType>, *parent, std::placeholders::_1 ) );
   }
 
+  // Destroys the object through the dispatch table, which has to outlive the destroyer
+  template<class VkType>
+  inline void InitVkDestroyer( DeviceDispatch const & dispatch, VkDestroyer<VkType> & destroyer ) {
+    destroyer = VkDestroyer<VkType>( std::bind( DestroyVulkanObject<DeviceDispatch const *, VkType>, &dispatch, std::placeholders::_1 ) );
+  }
+
 } // namespace VulkanCookbook
 
 #endif // VULKAN_DESTROYER
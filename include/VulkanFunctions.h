@@ -32,15 +32,31 @@
 #ifndef VULKAN_FUNCTIONS
 #define VULKAN_FUNCTIONS
 #include "vulkan.h"
+#include "VulkanPromoted.h"
 
 namespace VulkanCookbook {
     #define EXPORTED_VULKAN_FUNCTION( name ) extern PFN_##name name;
     #define GLOBAL_LEVEL_VULKAN_FUNCTION( name ) extern PFN_##name name;
+    #define GLOBAL_LEVEL_VULKAN_FUNCTION_FROM_VERSION( name, version ) extern PFN_##name name;
     #define INSTANCE_LEVEL_VULKAN_FUNCTION( name ) extern PFN_##name name;
     #define INSTANCE_LEVEL_VULKAN_FUNCTION_FROM_EXTENSION( name, extension ) extern PFN_##name name;
+    #define INSTANCE_LEVEL_VULKAN_FUNCTION_FROM_VERSION( name, version ) extern PFN_##name name;
     #define DEVICE_LEVEL_VULKAN_FUNCTION( name ) extern PFN_##name name;
     #define DEVICE_LEVEL_VULKAN_FUNCTION_FROM_EXTENSION( name, extension ) extern PFN_##name name;
+    #define DEVICE_LEVEL_VULKAN_FUNCTION_FROM_VERSION( name, version, extension, extension_name ) extern PFN_##name name;
     #include "ListOfVulkanFunctions.inl"
 
+    // Device-level functions resolved for one logical device with vkGetDeviceProcAddr.
+    // Unlike the globals above, several of these can coexist in one process and
+    // calls through them don't go through the loader's dispatch trampoline.
+    struct DeviceDispatch {
+        VkDevice Device;
+
+        #define DEVICE_LEVEL_VULKAN_FUNCTION( name ) PFN_##name name;
+        #define DEVICE_LEVEL_VULKAN_FUNCTION_FROM_EXTENSION( name, extension ) PFN_##name name;
+        #define DEVICE_LEVEL_VULKAN_FUNCTION_FROM_VERSION( name, version, extension, extension_name ) PFN_##name name;
+        #include "ListOfVulkanFunctions.inl"
+    };
+
 } // namespace VulkanCookbook
 #endif 
\ No newline at end of file
@@ -27,6 +27,18 @@
 #define MY_TEST
 
 #include "Common.h"
+#include "PipelineCache.h"
+#include "CommandBuffers.h"
+#include "Resources.h"
+#include "Offscreen.h"
+#include "Swapchain.h"
+#include "FrameLoop.h"
+#include "PresentPolicy.h"
+#include "DeviceSelection.h"
+#include "QueueSelection.h"
+#include "MathKernels.h"
+#include "TimelineScheduler.h"
+#include "FencePool.h"
 #include <vector>
 #include <iostream>
 #include <stdexcept>
@@ -57,8 +69,10 @@ namespace VulkanCookbook {
                             std::vector<QueueInfo> queue_infos,
                             std::vector<char const *> const & desired_extensions,
                             VkPhysicalDeviceFeatures * desired_features,
-                            VkDevice & logical_device );
+                            VkDevice & logical_device,
+                            void const * features_chain = nullptr );
     void GetDeviceQueue( VkDevice logical_device, uint32_t queue_family_index, uint32_t queue_index, VkQueue & queue );
+    std::vector<QueueInfo> PrepareQueueInfos( QueueLayout const & queue_layout );
     bool CreateLogicalDeviceWithGeometryShadersAndGraphicsAndComputeQueues( VkInstance   instance,
                                                                             VkDevice   & logical_device,
                                                                             VkQueue    & graphics_queue,
@@ -78,7 +92,8 @@ namespace VulkanCookbook {
                                                       std::vector< QueueInfo >    queue_infos,
                                                       std::vector<char const *> & desired_extensions,
                                                       VkPhysicalDeviceFeatures  * desired_features,
-                                                      VkDevice                  & logical_device );
+                                                      VkDevice                  & logical_device,
+                                                      void const                * features_chain = nullptr );
     bool SelectDesiredPresentationMode( VkPhysicalDevice   physical_device,
                                         VkSurfaceKHR       presentation_surface,
                                         VkPresentModeKHR   desired_present_mode,
@@ -88,6 +103,9 @@ namespace VulkanCookbook {
                                                VkSurfaceCapabilitiesKHR & surface_capabilities );
     bool SelectNumberOfSwapchainImages( VkSurfaceCapabilitiesKHR const & surface_capabilities,
                                         uint32_t                       & number_of_images );
+    bool RenderHeadlessFrame( VkPhysicalDevice    physical_device,
+                              VkExtent2D          size,
+                              std::string const & output_filename );
 } //namespace
 
 #endif
\ No newline at end of file
@@ -0,0 +1,197 @@
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Command Buffer Pool
+
+#include "CommandBufferPool.h"
+#include "CommandBuffers.h"
+#include <algorithm>
+
+namespace VulkanCookbook {
+
+  CommandBufferPool::CommandBufferPool() :
+    Dispatch( nullptr ),
+    CurrentFrame( 0 ),
+    Statistics() {
+  }
+
+  CommandBufferPool::~CommandBufferPool() {
+    Destroy();
+  }
+
+  bool CommandBufferPool::Initialize( DeviceDispatch const & dispatch,
+                                      uint32_t               frames_in_flight ) {
+    Destroy();
+
+    Dispatch = &dispatch;
+    CurrentFrame = 0;
+    FramePools.resize( std::max( frames_in_flight, 1u ) );
+    Statistics = {};
+    return true;
+  }
+
+  void CommandBufferPool::Destroy() {
+    if( nullptr == Dispatch ) {
+      return;
+    }
+    // Command buffers are freed together with their pools
+    FramePools.clear();
+    TrackedPools.clear();
+    Dispatch = nullptr;
+  }
+
+  bool CommandBufferPool::BeginFrame( uint64_t frame_index ) {
+    if( FramePools.empty() ) {
+      return false;
+    }
+    CurrentFrame = static_cast<uint32_t>(frame_index % FramePools.size());
+
+    for( auto & pool : FramePools[CurrentFrame] ) {
+      if( 0 == pool->UsedCount ) {
+        continue;
+      }
+      VkResult result = Dispatch->vkResetCommandPool( Dispatch->Device, *pool->Pool, 0 );
+      if( VK_SUCCESS != result ) {
+        std::cout << "Could not reset command pool." << std::endl;
+        return false;
+      }
+      pool->UsedCount = 0;
+      ++Statistics.CommandPoolResets;
+    }
+    return true;
+  }
+
+  bool CommandBufferPool::AcquireFrameCommandBuffer( uint32_t               queue_family,
+                                                     VkCommandBufferLevel   level,
+                                                     VkCommandBuffer      & command_buffer ) {
+    if( FramePools.empty() ) {
+      return false;
+    }
+    // Command buffers are only reset together with the whole pool
+    RecycledCommandBuffers * pool = FindPool( FramePools[CurrentFrame], queue_family, level, VK_COMMAND_POOL_CREATE_TRANSIENT_BIT );
+    if( nullptr == pool ) {
+      return false;
+    }
+
+    if( pool->UsedCount < pool->CommandBuffers.size() ) {
+      ++Statistics.AllocationsAvoided;
+    } else if( !AllocateCommandBuffer( *pool ) ) {
+      return false;
+    }
+    command_buffer = pool->CommandBuffers[pool->UsedCount++];
+    return true;
+  }
+
+  bool CommandBufferPool::AcquireCommandBuffer( uint32_t               queue_family,
+                                                VkCommandBufferLevel   level,
+                                                VkCommandBuffer      & command_buffer ) {
+    if( nullptr == Dispatch ) {
+      return false;
+    }
+    RecycledCommandBuffers * pool = FindPool( TrackedPools, queue_family, level, VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT );
+    if( nullptr == pool ) {
+      return false;
+    }
+
+    // Fences are polled only when nothing is available, which keeps the common case cheap
+    if( pool->Available.empty() ) {
+      auto still_executing = std::remove_if( pool->Submitted.begin(), pool->Submitted.end(), [&]( std::pair<VkCommandBuffer, VkFence> const & submitted ) {
+        if( VK_SUCCESS != Dispatch->vkGetFenceStatus( Dispatch->Device, submitted.second ) ) {
+          return false;
+        }
+        pool->Available.push_back( submitted.first );
+        return true;
+      } );
+      pool->Submitted.erase( still_executing, pool->Submitted.end() );
+    }
+
+    if( !pool->Available.empty() ) {
+      command_buffer = pool->Available.back();
+      VkResult result = Dispatch->vkResetCommandBuffer( command_buffer, 0 );
+      if( VK_SUCCESS != result ) {
+        std::cout << "Could not reset command buffer." << std::endl;
+        return false;
+      }
+      pool->Available.pop_back();
+      ++Statistics.CommandBufferResets;
+      ++Statistics.AllocationsAvoided;
+    } else {
+      if( !AllocateCommandBuffer( *pool ) ) {
+        return false;
+      }
+      command_buffer = pool->CommandBuffers.back();
+    }
+    pool->Acquired.push_back( command_buffer );
+    return true;
+  }
+
+  void CommandBufferPool::ReleaseCommandBuffer( VkCommandBuffer   command_buffer,
+                                                VkFence           fence ) {
+    for( auto & pool : TrackedPools ) {
+      auto acquired = std::find( pool->Acquired.begin(), pool->Acquired.end(), command_buffer );
+      if( acquired == pool->Acquired.end() ) {
+        continue;
+      }
+      pool->Acquired.erase( acquired );
+      if( VK_NULL_HANDLE == fence ) {
+        pool->Available.push_back( command_buffer );
+      } else {
+        pool->Submitted.push_back( { command_buffer, fence } );
+      }
+      return;
+    }
+    std::cout << "Could not release command buffer - it was not acquired from this pool." << std::endl;
+  }
+
+  RecycledCommandBuffers * CommandBufferPool::FindPool( std::vector<std::unique_ptr<RecycledCommandBuffers>> & pools,
+                                                        uint32_t                                               queue_family,
+                                                        VkCommandBufferLevel                                   level,
+                                                        VkCommandPoolCreateFlags                               flags ) {
+    // Only a few queue families and two levels - a linear search is enough
+    for( auto & pool : pools ) {
+      if( (queue_family == pool->QueueFamily) &&
+          (level == pool->Level) ) {
+        return pool.get();
+      }
+    }
+
+    std::unique_ptr<RecycledCommandBuffers> pool( new RecycledCommandBuffers() );
+    pool->QueueFamily = queue_family;
+    pool->Level = level;
+    pool->UsedCount = 0;
+    InitVkDestroyer( *Dispatch, pool->Pool );
+    if( !CreateCommandPool( *Dispatch, flags, queue_family, *pool->Pool ) ) {
+      return nullptr;
+    }
+    pools.push_back( std::move( pool ) );
+    return pools.back().get();
+  }
+
+  bool CommandBufferPool::AllocateCommandBuffer( RecycledCommandBuffers & pool ) {
+    std::vector<VkCommandBuffer> command_buffers;
+    if( !AllocateCommandBuffers( *Dispatch, *pool.Pool, pool.Level, 1, command_buffers ) ) {
+      return false;
+    }
+    pool.CommandBuffers.push_back( command_buffers[0] );
+    ++Statistics.CommandBuffersAllocated;
+    return true;
+  }
+
+} // namespace VulkanCookbook
@@ -0,0 +1,193 @@
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Command Buffers and Synchronization
+
+#include "CommandBuffers.h"
+
+namespace VulkanCookbook {
+
+  bool CreateCommandPool( DeviceDispatch const     & dispatch,
+                          VkCommandPoolCreateFlags   parameters,
+                          uint32_t                   queue_family,
+                          VkCommandPool            & command_pool ) {
+    VkCommandPoolCreateInfo command_pool_create_info = {
+      VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,   // VkStructureType              sType
+      nullptr,                                      // const void                 * pNext
+      parameters,                                   // VkCommandPoolCreateFlags     flags
+      queue_family                                  // uint32_t                     queueFamilyIndex
+    };
+
+    VkResult result = dispatch.vkCreateCommandPool( dispatch.Device, &command_pool_create_info, nullptr, &command_pool );
+    if( VK_SUCCESS != result ) {
+      std::cout << "Could not create command pool." << std::endl;
+      return false;
+    }
+    return true;
+  }
+
+  bool AllocateCommandBuffers( DeviceDispatch const         & dispatch,
+                               VkCommandPool                  command_pool,
+                               VkCommandBufferLevel           level,
+                               uint32_t                       count,
+                               std::vector<VkCommandBuffer> & command_buffers ) {
+    VkCommandBufferAllocateInfo command_buffer_allocate_info = {
+      VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,   // VkStructureType          sType
+      nullptr,                                          // const void             * pNext
+      command_pool,                                     // VkCommandPool            commandPool
+      level,                                            // VkCommandBufferLevel     level
+      count                                             // uint32_t                 commandBufferCount
+    };
+
+    command_buffers.resize( count );
+
+    VkResult result = dispatch.vkAllocateCommandBuffers( dispatch.Device, &command_buffer_allocate_info, command_buffers.data() );
+    if( VK_SUCCESS != result ) {
+      std::cout << "Could not allocate command buffers." << std::endl;
+      return false;
+    }
+    return true;
+  }
+
+  bool BeginCommandBufferRecordingOperation( DeviceDispatch const           & dispatch,
+                                             VkCommandBuffer                  command_buffer,
+                                             VkCommandBufferUsageFlags        usage,
+                                             VkCommandBufferInheritanceInfo * secondary_command_buffer_info ) {
+    VkCommandBufferBeginInfo command_buffer_begin_info = {
+      VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,    // VkStructureType                        sType
+      nullptr,                                        // const void                           * pNext
+      usage,                                          // VkCommandBufferUsageFlags              flags
+      secondary_command_buffer_info                   // const VkCommandBufferInheritanceInfo * pInheritanceInfo
+    };
+
+    VkResult result = dispatch.vkBeginCommandBuffer( command_buffer, &command_buffer_begin_info );
+    if( VK_SUCCESS != result ) {
+      std::cout << "Could not begin command buffer recording operation." << std::endl;
+      return false;
+    }
+    return true;
+  }
+
+  bool EndCommandBufferRecordingOperation( DeviceDispatch const & dispatch,
+                                           VkCommandBuffer        command_buffer ) {
+    VkResult result = dispatch.vkEndCommandBuffer( command_buffer );
+    if( VK_SUCCESS != result ) {
+      std::cout << "Error occurred during command buffer recording." << std::endl;
+      return false;
+    }
+    return true;
+  }
+
+  bool CreateSemaphore( DeviceDispatch const & dispatch,
+                        VkSemaphore          & semaphore ) {
+    VkSemaphoreCreateInfo semaphore_create_info = {
+      VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,    // VkStructureType            sType
+      nullptr,                                    // const void               * pNext
+      0                                           // VkSemaphoreCreateFlags     flags
+    };
+
+    VkResult result = dispatch.vkCreateSemaphore( dispatch.Device, &semaphore_create_info, nullptr, &semaphore );
+    if( VK_SUCCESS != result ) {
+      std::cout << "Could not create a semaphore." << std::endl;
+      return false;
+    }
+    return true;
+  }
+
+  bool CreateFence( DeviceDispatch const & dispatch,
+                    bool                   signaled,
+                    VkFence              & fence ) {
+    VkFenceCreateInfo fence_create_info = {
+      VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,          // VkStructureType        sType
+      nullptr,                                      // const void           * pNext
+      signaled ? static_cast<VkFenceCreateFlags>(VK_FENCE_CREATE_SIGNALED_BIT) : 0u  // VkFenceCreateFlags     flags
+    };
+
+    VkResult result = dispatch.vkCreateFence( dispatch.Device, &fence_create_info, nullptr, &fence );
+    if( VK_SUCCESS != result ) {
+      std::cout << "Could not create a fence." << std::endl;
+      return false;
+    }
+    return true;
+  }
+
+  bool WaitForFences( DeviceDispatch const       & dispatch,
+                      std::vector<VkFence> const & fences,
+                      VkBool32                     wait_for_all,
+                      uint64_t                     timeout ) {
+    if( fences.size() > 0 ) {
+      VkResult result = dispatch.vkWaitForFences( dispatch.Device, static_cast<uint32_t>(fences.size()), fences.data(), wait_for_all, timeout );
+      if( VK_SUCCESS != result ) {
+        std::cout << "Waiting on fence failed." << std::endl;
+        return false;
+      }
+      return true;
+    }
+    return false;
+  }
+
+  bool ResetFences( DeviceDispatch const       & dispatch,
+                    std::vector<VkFence> const & fences ) {
+    if( fences.size() > 0 ) {
+      VkResult result = dispatch.vkResetFences( dispatch.Device, static_cast<uint32_t>(fences.size()), fences.data() );
+      if( VK_SUCCESS != result ) {
+        std::cout << "Error occurred when tried to reset fences." << std::endl;
+        return false;
+      }
+      return VK_SUCCESS == result;
+    }
+    return false;
+  }
+
+  bool SubmitCommandBuffersToQueue( DeviceDispatch const           & dispatch,
+                                    VkQueue                          queue,
+                                    std::vector<WaitSemaphoreInfo>   wait_semaphore_infos,
+                                    std::vector<VkCommandBuffer>     command_buffers,
+                                    std::vector<VkSemaphore>         signal_semaphores,
+                                    VkFence                          fence ) {
+    std::vector<VkSemaphore>          wait_semaphore_handles;
+    std::vector<VkPipelineStageFlags> wait_semaphore_stages;
+
+    for( auto & wait_semaphore_info : wait_semaphore_infos ) {
+      wait_semaphore_handles.emplace_back( wait_semaphore_info.Semaphore );
+      wait_semaphore_stages.emplace_back( wait_semaphore_info.WaitingStage );
+    }
+
+    VkSubmitInfo submit_info = {
+      VK_STRUCTURE_TYPE_SUBMIT_INFO,                        // VkStructureType                sType
+      nullptr,                                              // const void                   * pNext
+      static_cast<uint32_t>(wait_semaphore_infos.size()),   // uint32_t                       waitSemaphoreCount
+      wait_semaphore_handles.data(),                        // const VkSemaphore            * pWaitSemaphores
+      wait_semaphore_stages.data(),                         // const VkPipelineStageFlags   * pWaitDstStageMask
+      static_cast<uint32_t>(command_buffers.size()),        // uint32_t                       commandBufferCount
+      command_buffers.data(),                               // const VkCommandBuffer        * pCommandBuffers
+      static_cast<uint32_t>(signal_semaphores.size()),      // uint32_t                       signalSemaphoreCount
+      signal_semaphores.data()                              // const VkSemaphore            * pSignalSemaphores
+    };
+
+    VkResult result = dispatch.vkQueueSubmit( queue, 1, &submit_info, fence );
+    if( VK_SUCCESS != result ) {
+      std::cout << "Error occurred during command buffer submission." << std::endl;
+      return false;
+    }
+    return true;
+  }
+
+} // namespace VulkanCookbook
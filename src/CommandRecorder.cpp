@@ -0,0 +1,146 @@
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Command Recorder
+
+#include "CommandRecorder.h"
+#include "CommandBuffers.h"
+
+namespace VulkanCookbook {
+
+  CommandRecorder::CommandRecorder() :
+    Dispatch( nullptr ),
+    QueueFamily( 0 ),
+    Workers( nullptr ),
+    FrameStarted( false ) {
+  }
+
+  CommandRecorder::~CommandRecorder() {
+    Destroy();
+  }
+
+  bool CommandRecorder::Initialize( DeviceDispatch const & dispatch,
+                                    uint32_t               queue_family,
+                                    ThreadPool           & thread_pool,
+                                    uint32_t               frames_in_flight ) {
+    Destroy();
+
+    Dispatch = &dispatch;
+    QueueFamily = queue_family;
+    Workers = &thread_pool;
+    FrameStarted = false;
+
+    for( uint32_t thread = 0; thread < thread_pool.GetThreadCount(); ++thread ) {
+      Pools.emplace_back( new CommandBufferPool() );
+      if( !Pools.back()->Initialize( *Dispatch, frames_in_flight ) ) {
+        Destroy();
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void CommandRecorder::Destroy() {
+    if( nullptr == Dispatch ) {
+      return;
+    }
+    Pools.clear();
+    Workers = nullptr;
+    Dispatch = nullptr;
+  }
+
+  bool CommandRecorder::BeginFrame( uint64_t frame_index ) {
+    if( Pools.empty() ) {
+      return false;
+    }
+    FrameStarted = false;
+    for( auto & pool : Pools ) {
+      if( !pool->BeginFrame( frame_index ) ) {
+        return false;
+      }
+    }
+    FrameStarted = true;
+    return true;
+  }
+
+  bool CommandRecorder::RecordAndExecute( VkCommandBuffer                         primary_command_buffer,
+                                          VkCommandBufferInheritanceInfo const  & inheritance,
+                                          std::vector<RecordFunction> const     & jobs ) {
+    if( !FrameStarted ) {
+      std::cout << "Could not record secondary command buffers - the frame was not started." << std::endl;
+      return false;
+    }
+    if( jobs.empty() ) {
+      return true;
+    }
+
+    VkCommandBufferUsageFlags usage = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    if( VK_NULL_HANDLE != inheritance.renderPass ) {
+      usage |= VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+    }
+
+    std::vector<VkCommandBuffer> secondary_command_buffers( jobs.size(), VK_NULL_HANDLE );
+    std::vector<std::future<bool>> tasks;
+    tasks.reserve( jobs.size() );
+    for( uint32_t job = 0; job < static_cast<uint32_t>(jobs.size()); ++job ) {
+      tasks.push_back( Workers->Submit( [&, job]( uint32_t worker_index ) {
+        VkCommandBuffer command_buffer;
+        if( !Pools[worker_index]->AcquireFrameCommandBuffer( QueueFamily, VK_COMMAND_BUFFER_LEVEL_SECONDARY, command_buffer ) ) {
+          return false;
+        }
+        VkCommandBufferInheritanceInfo inheritance_info = inheritance;
+        // Left in the recording state on failure, the next pool reset cleans it up
+        if( !BeginCommandBufferRecordingOperation( *Dispatch, command_buffer, usage, &inheritance_info ) ||
+            !jobs[job]( command_buffer, job ) ||
+            !EndCommandBufferRecordingOperation( *Dispatch, command_buffer ) ) {
+          return false;
+        }
+        secondary_command_buffers[job] = command_buffer;
+        return true;
+      } ) );
+    }
+
+    // All tasks have to finish before returning, as they reference local data
+    bool success = true;
+    for( auto & task : tasks ) {
+      success = task.get() && success;
+    }
+    if( !success ) {
+      std::cout << "Could not record secondary command buffers." << std::endl;
+      return false;
+    }
+
+    Dispatch->vkCmdExecuteCommands( primary_command_buffer, static_cast<uint32_t>(secondary_command_buffers.size()), secondary_command_buffers.data() );
+    return true;
+  }
+
+  CommandBufferPoolStatistics CommandRecorder::GetStatistics() const {
+    CommandBufferPoolStatistics statistics = {};
+    for( auto & pool : Pools ) {
+      CommandBufferPoolStatistics const & pool_statistics = pool->GetStatistics();
+      statistics.CommandBuffersAllocated += pool_statistics.CommandBuffersAllocated;
+      statistics.AllocationsAvoided += pool_statistics.AllocationsAvoided;
+      statistics.CommandPoolResets += pool_statistics.CommandPoolResets;
+      statistics.CommandBufferResets += pool_statistics.CommandBufferResets;
+    }
+    return statistics;
+  }
+
+} // namespace VulkanCookbook
@@ -25,6 +25,7 @@
 //
 // Common
 
+#include <algorithm>
 #include "Common.h"
 
 namespace VulkanCookbook {
@@ -57,11 +58,17 @@ namespace VulkanCookbook {
         #name << std::endl;                                             \
       return false;                                                     \
     }
+
+    #undef GLOBAL_LEVEL_VULKAN_FUNCTION_FROM_VERSION
+    #define GLOBAL_LEVEL_VULKAN_FUNCTION_FROM_VERSION( name, version )  \
+    name = (PFN_##name)vkGetInstanceProcAddr( nullptr, #name );
     #include "ListOfVulkanFunctions.inl"
     return true;
   }
 
   bool LoadInstanceLevelFunctions(VkInstance instance, std::vector<char const *> const &enabled_extensions) {
+    ExtensionTable enabled_extension_table( enabled_extensions );
+
     // Load core Vulkan API instance-level functions
     #undef INSTANCE_LEVEL_VULKAN_FUNCTION
     #define INSTANCE_LEVEL_VULKAN_FUNCTION(name) \
@@ -73,16 +80,20 @@ namespace VulkanCookbook {
 
     // Load instance-level functions from enabled extensions
     #undef INSTANCE_LEVEL_VULKAN_FUNCTION_FROM_EXTENSION
-    #define INSTANCE_LEVEL_VULKAN_FUNCTION_FROM_EXTENSION(name, extension)                          \
-    for (auto &enabled_extension : enabled_extensions) {                                            \
-      if (std::string(enabled_extension) == std::string(extension)) {                               \
-        name = (PFN_##name)vkGetInstanceProcAddr(instance, #name);                                  \
-        if (name == nullptr) {                                                                      \
-            std::cout << "Could not load instance-level Vulkan function named: " #name << std::endl;\
-            return false;                                                                           \
-        }                                                                                           \
-      }                                                                                             \
+    #define INSTANCE_LEVEL_VULKAN_FUNCTION_FROM_EXTENSION(name, extension)                                        \
+    if (enabled_extension_table.Contains(EXTENSION_NAME_HASH(extension), extension)) {                            \
+      name = (PFN_##name)vkGetInstanceProcAddr(instance, #name);                                                  \
+      if (name == nullptr) {                                                                                      \
+          std::cout << "Could not load instance-level Vulkan function named: " #name << std::endl;                \
+          return false;                                                                                           \
+      }                                                                                                           \
     }
+
+    // Load promoted functions when the instance was created with their version, leave them null otherwise
+    uint32_t instance_api_version = SelectInstanceApiVersion();
+    #undef INSTANCE_LEVEL_VULKAN_FUNCTION_FROM_VERSION
+    #define INSTANCE_LEVEL_VULKAN_FUNCTION_FROM_VERSION(name, version)                                            \
+    name = (instance_api_version >= version) ? (PFN_##name)vkGetInstanceProcAddr(instance, #name) : nullptr;
     #include "ListOfVulkanFunctions.inl"
 
     return true;
@@ -91,42 +102,104 @@ namespace VulkanCookbook {
   bool IsExtensionSupported( std::vector<VkExtensionProperties> const & available_extensions,
                              char const * const                         extension ) {
     for( auto & available_extension : available_extensions ) {
-      if( strstr( available_extension.extensionName, extension ) ) {
+      if( 0 == strcmp( available_extension.extensionName, extension ) ) {
         return true;
       }
     }
     return false;
   }
 
+  bool IsExtensionSupported( ExtensionTable const & available_extensions,
+                             char const * const     extension ) {
+    return available_extensions.Contains( extension );
+  }
+
   bool LoadDeviceLevelFunctions( VkDevice                          logical_device,
-                                std::vector<char const *> const & enabled_extensions ) {
-    // Load core Vulkan API device-level functions
-    #define DEVICE_LEVEL_VULKAN_FUNCTION( name )                                    \
-    name = (PFN_##name)vkGetDeviceProcAddr( logical_device, #name );            \
-    if( name == nullptr ) {                                                     \
-      std::cout << "Could not load device-level Vulkan function named: "        \
-        #name << std::endl;                                                     \
-      return false;                                                             \
+                                std::vector<char const *> const & enabled_extensions,
+                                uint32_t                          api_version ) {
+    DeviceDispatch dispatch;
+    if( !LoadDeviceLevelFunctions( logical_device, enabled_extensions, dispatch, api_version ) ) {
+      return false;
     }
 
+    #define DEVICE_LEVEL_VULKAN_FUNCTION( name ) name = dispatch.name;
+    #define DEVICE_LEVEL_VULKAN_FUNCTION_FROM_EXTENSION( name, extension ) name = dispatch.name;
+    #define DEVICE_LEVEL_VULKAN_FUNCTION_FROM_VERSION( name, version, extension, extension_name ) name = dispatch.name;
     #include "ListOfVulkanFunctions.inl"
 
+    return true;
+  }
+
+  bool LoadDeviceLevelFunctions( VkDevice                          logical_device,
+                                 std::vector<char const *> const & enabled_extensions,
+                                 DeviceDispatch                  & dispatch,
+                                 uint32_t                          api_version ) {
+    ExtensionTable enabled_extension_table( enabled_extensions );
+
+    dispatch = {};
+    dispatch.Device = logical_device;
+
+    // Load core Vulkan API device-level functions
+    #define DEVICE_LEVEL_VULKAN_FUNCTION( name )                                              \
+    dispatch.name = (PFN_##name)vkGetDeviceProcAddr( logical_device, #name );                 \
+    if( dispatch.name == nullptr ) {                                                          \
+      std::cout << "Could not load device-level Vulkan function named: "                      \
+        #name << std::endl;                                                                   \
+      return false;                                                                           \
+    }
+
     // Load device-level functions from enabled extensions
-    #define DEVICE_LEVEL_VULKAN_FUNCTION_FROM_EXTENSION( name, extension )          \
-    for( auto & enabled_extension : enabled_extensions ) {                      \
-      if( std::string( enabled_extension ) == std::string( extension ) ) {      \
-        name = (PFN_##name)vkGetDeviceProcAddr( logical_device, #name );        \
-        if( name == nullptr ) {                                                 \
-          std::cout << "Could not load device-level Vulkan function from extension named: "    \
-            #name << std::endl;                                                 \
-          return false;                                                         \
-        }                                                                       \
-      }                                                                         \
+    #define DEVICE_LEVEL_VULKAN_FUNCTION_FROM_EXTENSION( name, extension )                      \
+    if( enabled_extension_table.Contains( EXTENSION_NAME_HASH( extension ), extension ) ) { \
+      dispatch.name = (PFN_##name)vkGetDeviceProcAddr( logical_device, #name );             \
+      if( dispatch.name == nullptr ) {                                                      \
+        std::cout << "Could not load device-level Vulkan function from extension named: "  \
+          #name << std::endl;                                                               \
+        return false;                                                                       \
+      }                                                                                     \
     }
 
+    // Load promoted functions by their core or extension name, leave them null otherwise
+    #define DEVICE_LEVEL_VULKAN_FUNCTION_FROM_VERSION( name, version, extension, extension_name )        \
+    if( api_version >= version ) {                                                                   \
+      dispatch.name = (PFN_##name)vkGetDeviceProcAddr( logical_device, #name );                      \
+      if( dispatch.name == nullptr ) {                                                               \
+        std::cout << "Could not load device-level Vulkan function named: "                           \
+          #name << std::endl;                                                                        \
+        return false;                                                                                \
+      }                                                                                              \
+    } else if( enabled_extension_table.Contains( EXTENSION_NAME_HASH( extension ), extension ) ) {   \
+      dispatch.name = (PFN_##name)vkGetDeviceProcAddr( logical_device, #extension_name );            \
+      if( dispatch.name == nullptr ) {                                                               \
+        std::cout << "Could not load device-level Vulkan function from extension named: "           \
+          #extension_name << std::endl;                                                              \
+        return false;                                                                                \
+      }                                                                                              \
+    }
+
+    #include "ListOfVulkanFunctions.inl"
+
     return true;
   }
 
+  uint32_t SelectInstanceApiVersion() {
+    // Vulkan 1.0 loaders don't export vkEnumerateInstanceVersion at all
+    uint32_t loader_version = VK_API_VERSION_1_0;
+    if( (nullptr != vkEnumerateInstanceVersion) &&
+        (VK_SUCCESS != vkEnumerateInstanceVersion( &loader_version )) ) {
+      loader_version = VK_API_VERSION_1_0;
+    }
+    loader_version = VK_MAKE_VERSION( VK_VERSION_MAJOR( loader_version ), VK_VERSION_MINOR( loader_version ), 0 );
+    return std::min<uint32_t>( loader_version, VK_API_VERSION_1_3 );
+  }
+
+  uint32_t GetNegotiatedApiVersion( VkPhysicalDevice physical_device ) {
+    VkPhysicalDeviceProperties device_properties;
+    vkGetPhysicalDeviceProperties( physical_device, &device_properties );
+
+    uint32_t device_version = VK_MAKE_VERSION( VK_VERSION_MAJOR( device_properties.apiVersion ), VK_VERSION_MINOR( device_properties.apiVersion ), 0 );
+    return std::min( SelectInstanceApiVersion(), device_version );
+  }
 
   bool IsLayerSupported( std::vector<VkLayerProperties> const & available_layers,
                              char const * const                         layer ) {
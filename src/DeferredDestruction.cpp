@@ -0,0 +1,88 @@
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Deferred Destruction
+
+#include <iterator>
+#include "DeferredDestruction.h"
+
+namespace VulkanCookbook {
+
+  DeferredDestructionQueue::DeferredDestructionQueue() :
+    CurrentValue( 0 ),
+    RetiredObjectCount( 0 ) {
+  }
+
+  DeferredDestructionQueue::~DeferredDestructionQueue() {
+    DestroyAll();
+  }
+
+  void DeferredDestructionQueue::SetCurrentValue( uint64_t value ) {
+    std::lock_guard<std::mutex> lock( Mutex );
+    CurrentValue = value;
+  }
+
+  uint64_t DeferredDestructionQueue::GetCurrentValue() const {
+    std::lock_guard<std::mutex> lock( Mutex );
+    return CurrentValue;
+  }
+
+  void DeferredDestructionQueue::Retire( std::unique_ptr<RetiredObject> object,
+                                         uint64_t                       value ) {
+    std::lock_guard<std::mutex> lock( Mutex );
+
+    // Values usually only grow, so the last group is the right one
+    auto group = Groups.end();
+    while( (group != Groups.begin()) &&
+           (std::prev( group )->Value >= value) ) {
+      --group;
+    }
+    if( (group == Groups.end()) ||
+        (group->Value != value) ) {
+      group = Groups.insert( group, RetiredGroup{ value, {} } );
+    }
+    group->Objects.push_back( std::move( object ) );
+    ++RetiredObjectCount;
+  }
+
+  void DeferredDestructionQueue::Collect( uint64_t completed_value ) {
+    // Objects are destroyed outside of the lock, so other threads can keep retiring
+    std::vector<RetiredGroup> completed_groups;
+    {
+      std::lock_guard<std::mutex> lock( Mutex );
+      while( !Groups.empty() &&
+             (Groups.front().Value <= completed_value) ) {
+        RetiredObjectCount -= Groups.front().Objects.size();
+        completed_groups.push_back( std::move( Groups.front() ) );
+        Groups.pop_front();
+      }
+    }
+  }
+
+  void DeferredDestructionQueue::DestroyAll() {
+    Collect( UINT64_MAX );
+  }
+
+  size_t DeferredDestructionQueue::GetRetiredObjectCount() const {
+    std::lock_guard<std::mutex> lock( Mutex );
+    return RetiredObjectCount;
+  }
+
+} // namespace VulkanCookbook
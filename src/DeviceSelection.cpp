@@ -0,0 +1,270 @@
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Device Selection
+
+#include "DeviceSelection.h"
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+#include <tuple>
+
+namespace VulkanCookbook {
+
+  namespace {
+
+    uint32_t GetDeviceTypeRank( VkPhysicalDeviceType type ) {
+      switch( type ) {
+      case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU:
+        return 4;
+      case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU:
+        return 3;
+      case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU:
+        return 2;
+      case VK_PHYSICAL_DEVICE_TYPE_CPU:
+        return 1;
+      default:
+        return 0;
+      }
+    }
+
+    bool AreFeaturesSupported( VkPhysicalDeviceFeatures const & available_features,
+                               VkPhysicalDeviceFeatures const & required_features ) {
+      // VkPhysicalDeviceFeatures consists of VkBool32 members only
+      size_t const count = sizeof( VkPhysicalDeviceFeatures ) / sizeof( VkBool32 );
+      VkBool32 const * available = reinterpret_cast<VkBool32 const *>(&available_features);
+      VkBool32 const * required = reinterpret_cast<VkBool32 const *>(&required_features);
+      for( size_t i = 0; i < count; ++i ) {
+        if( required[i] && !available[i] ) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    std::string ToLower( std::string text ) {
+      std::transform( text.begin(), text.end(), text.begin(), []( unsigned char c ) {
+        return static_cast<char>(std::tolower( c ));
+      } );
+      return text;
+    }
+
+    std::string UuidToString( uint8_t const (&uuid)[VK_UUID_SIZE] ) {
+      static char const digits[] = "0123456789abcdef";
+      std::string text;
+      for( uint32_t i = 0; i < VK_UUID_SIZE; ++i ) {
+        text.push_back( digits[uuid[i] >> 4] );
+        text.push_back( digits[uuid[i] & 0xF] );
+      }
+      return text;
+    }
+
+    bool GetDeviceUuid( VkPhysicalDevice   physical_device,
+                        uint8_t          (&uuid)[VK_UUID_SIZE] ) {
+      if( (nullptr == vkGetPhysicalDeviceProperties2) ||
+          (GetNegotiatedApiVersion( physical_device ) < VK_API_VERSION_1_1) ) {
+        return false;
+      }
+
+      VkPhysicalDeviceIDProperties id_properties = {};
+      id_properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ID_PROPERTIES;
+      VkPhysicalDeviceProperties2 device_properties = {};
+      device_properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+      device_properties.pNext = &id_properties;
+      vkGetPhysicalDeviceProperties2( physical_device, &device_properties );
+
+      std::copy( std::begin( id_properties.deviceUUID ), std::end( id_properties.deviceUUID ), uuid );
+      return true;
+    }
+
+  } // namespace
+
+  DeviceRequirements MakeDeviceRequirements( VkQueueFlags queue_capabilities ) {
+    DeviceRequirements requirements = {};
+    requirements.QueueCapabilities = queue_capabilities;
+    requirements.PresentationSurface = VK_NULL_HANDLE;
+    return requirements;
+  }
+
+  PhysicalDeviceScore ScorePhysicalDevice( VkPhysicalDevice           physical_device,
+                                           DeviceRequirements const & requirements ) {
+    VkPhysicalDeviceProperties device_properties;
+    VkPhysicalDeviceFeatures device_features;
+    VkPhysicalDeviceMemoryProperties memory_properties;
+    vkGetPhysicalDeviceProperties( physical_device, &device_properties );
+    vkGetPhysicalDeviceFeatures( physical_device, &device_features );
+    vkGetPhysicalDeviceMemoryProperties( physical_device, &memory_properties );
+
+    PhysicalDeviceScore score = {};
+    score.PhysicalDevice = physical_device;
+    score.Name = device_properties.deviceName;
+    score.TypeRank = GetDeviceTypeRank( device_properties.deviceType );
+
+    // Integrated devices expose system memory as device local, which is fine - they are already ranked lower
+    for( uint32_t heap = 0; heap < memory_properties.memoryHeapCount; ++heap ) {
+      if( memory_properties.memoryHeaps[heap].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT ) {
+        score.DeviceLocalMemorySize = std::max( score.DeviceLocalMemorySize, memory_properties.memoryHeaps[heap].size );
+      }
+    }
+
+    uint32_t queue_families_count = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties( physical_device, &queue_families_count, nullptr );
+    std::vector<VkQueueFamilyProperties> queue_families( queue_families_count );
+    vkGetPhysicalDeviceQueueFamilyProperties( physical_device, &queue_families_count, queue_families.data() );
+
+    bool queue_requirements_met = false;
+    bool has_async_compute_family = false;
+    bool has_dedicated_transfer_family = false;
+    for( uint32_t index = 0; index < queue_families_count; ++index ) {
+      VkQueueFlags flags = queue_families[index].queueFlags;
+      if( 0 == queue_families[index].queueCount ) {
+        continue;
+      }
+      if( (flags & VK_QUEUE_COMPUTE_BIT) && !(flags & VK_QUEUE_GRAPHICS_BIT) ) {
+        has_async_compute_family = true;
+      }
+      if( (flags & VK_QUEUE_TRANSFER_BIT) && !(flags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT)) ) {
+        has_dedicated_transfer_family = true;
+      }
+      if( (flags & requirements.QueueCapabilities) != requirements.QueueCapabilities ) {
+        continue;
+      }
+      if( VK_NULL_HANDLE != requirements.PresentationSurface ) {
+        VkBool32 presentation_supported = VK_FALSE;
+        VkResult result = vkGetPhysicalDeviceSurfaceSupportKHR( physical_device, index, requirements.PresentationSurface, &presentation_supported );
+        if( (VK_SUCCESS != result) || (VK_TRUE != presentation_supported) ) {
+          continue;
+        }
+      }
+      queue_requirements_met = true;
+    }
+    score.QueueTopologyRank = (has_async_compute_family ? 2 : 0) + (has_dedicated_transfer_family ? 1 : 0);
+
+    bool extensions_supported = true;
+    if( requirements.Extensions.size() > 0 ) {
+      uint32_t extensions_count = 0;
+      vkEnumerateDeviceExtensionProperties( physical_device, nullptr, &extensions_count, nullptr );
+      std::vector<VkExtensionProperties> available_extensions( extensions_count );
+      vkEnumerateDeviceExtensionProperties( physical_device, nullptr, &extensions_count, available_extensions.data() );
+
+      ExtensionTable available_extension_table( available_extensions );
+      for( auto & extension : requirements.Extensions ) {
+        if( !available_extension_table.Contains( extension ) ) {
+          extensions_supported = false;
+          break;
+        }
+      }
+    }
+
+    score.MeetsRequirements = queue_requirements_met &&
+                              extensions_supported &&
+                              AreFeaturesSupported( device_features, requirements.Features );
+    return score;
+  }
+
+  bool RankPhysicalDevices( VkInstance                         instance,
+                            DeviceRequirements const         & requirements,
+                            std::vector<PhysicalDeviceScore> & ranked_devices ) {
+    uint32_t devices_count = 0;
+    VkResult result = vkEnumeratePhysicalDevices( instance, &devices_count, nullptr );
+    if( (VK_SUCCESS != result) ||
+        (0 == devices_count) ) {
+      std::cout << "Could not get the number of available physical devices." << std::endl;
+      return false;
+    }
+
+    std::vector<VkPhysicalDevice> physical_devices( devices_count );
+    result = vkEnumeratePhysicalDevices( instance, &devices_count, physical_devices.data() );
+    if( (VK_SUCCESS != result) ||
+        (0 == devices_count) ) {
+      std::cout << "Could not enumerate physical devices." << std::endl;
+      return false;
+    }
+
+    ranked_devices.clear();
+    for( auto & physical_device : physical_devices ) {
+      ranked_devices.push_back( ScorePhysicalDevice( physical_device, requirements ) );
+    }
+
+    // Stable, so equally scored devices keep the order reported by the driver
+    std::stable_sort( ranked_devices.begin(), ranked_devices.end(), []( PhysicalDeviceScore const & left, PhysicalDeviceScore const & right ) {
+      return std::tie( left.MeetsRequirements, left.TypeRank, left.DeviceLocalMemorySize, left.QueueTopologyRank ) >
+             std::tie( right.MeetsRequirements, right.TypeRank, right.DeviceLocalMemorySize, right.QueueTopologyRank );
+    } );
+    return true;
+  }
+
+  bool MatchPhysicalDevice( VkPhysicalDevice    physical_device,
+                            std::string const & name_or_uuid ) {
+    std::string pattern;
+    for( auto c : ToLower( name_or_uuid ) ) {
+      if( '-' != c ) {
+        pattern.push_back( c );
+      }
+    }
+    if( pattern.empty() ) {
+      return false;
+    }
+    // deviceUUID is unique per physical device and stable across driver updates
+    uint8_t device_uuid[VK_UUID_SIZE];
+    if( GetDeviceUuid( physical_device, device_uuid ) &&
+        (pattern == UuidToString( device_uuid )) ) {
+      return true;
+    }
+
+    VkPhysicalDeviceProperties device_properties;
+    vkGetPhysicalDeviceProperties( physical_device, &device_properties );
+    return std::string::npos != ToLower( device_properties.deviceName ).find( ToLower( name_or_uuid ) );
+  }
+
+  bool SelectPhysicalDevice( VkInstance                 instance,
+                             DeviceRequirements const & requirements,
+                             std::string const        & name_or_uuid_override,
+                             VkPhysicalDevice         & physical_device ) {
+    std::vector<PhysicalDeviceScore> ranked_devices;
+    if( !RankPhysicalDevices( instance, requirements, ranked_devices ) ) {
+      return false;
+    }
+
+    for( auto & ranked_device : ranked_devices ) {
+      if( !name_or_uuid_override.empty() ) {
+        if( !MatchPhysicalDevice( ranked_device.PhysicalDevice, name_or_uuid_override ) ) {
+          continue;
+        }
+        if( !ranked_device.MeetsRequirements ) {
+          std::cout << "Requested physical device '" << ranked_device.Name << "' does not meet the requirements." << std::endl;
+          return false;
+        }
+      } else if( !ranked_device.MeetsRequirements ) {
+        break;
+      }
+      physical_device = ranked_device.PhysicalDevice;
+      return true;
+    }
+
+    if( !name_or_uuid_override.empty() ) {
+      std::cout << "Could not find physical device matching '" << name_or_uuid_override << "'." << std::endl;
+    } else {
+      std::cout << "Could not find physical device meeting the requirements." << std::endl;
+    }
+    return false;
+  }
+
+} // namespace VulkanCookbook
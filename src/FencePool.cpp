@@ -0,0 +1,226 @@
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Fence Pool
+
+#include "FencePool.h"
+#include "CommandBuffers.h"
+
+namespace VulkanCookbook {
+
+  FencePool::FencePool() :
+    Dispatch( nullptr ),
+    Statistics() {
+  }
+
+  FencePool::~FencePool() {
+    Destroy();
+  }
+
+  bool FencePool::Initialize( DeviceDispatch const & dispatch ) {
+    Destroy();
+    Dispatch = &dispatch;
+    return true;
+  }
+
+  void FencePool::Destroy() {
+    Available.clear();
+    Released.clear();
+    Fences.clear();
+    Dispatch = nullptr;
+    Statistics = {};
+  }
+
+  bool FencePool::Acquire( VkFence & fence ) {
+    fence = VK_NULL_HANDLE;
+
+    // Reset all the released fences with one call instead of one per fence
+    if( Available.empty() &&
+        !Released.empty() ) {
+      if( !ResetFences( *Dispatch, Released ) ) {
+        return false;
+      }
+      Available.swap( Released );
+    }
+
+    if( !Available.empty() ) {
+      fence = Available.back();
+      Available.pop_back();
+      ++Statistics.FencesReused;
+      return true;
+    }
+
+    Fences.emplace_back();
+    InitVkDestroyer( *Dispatch, Fences.back() );
+    if( !CreateFence( *Dispatch, false, *Fences.back() ) ) {
+      Fences.pop_back();
+      return false;
+    }
+    fence = *Fences.back();
+    ++Statistics.FencesCreated;
+    return true;
+  }
+
+  void FencePool::Release( VkFence fence ) {
+    if( VK_NULL_HANDLE != fence ) {
+      Released.push_back( fence );
+    }
+  }
+
+  CompletionTracker::CompletionTracker() :
+    Dispatch( nullptr ),
+    Fences( nullptr ),
+    NextSubmissionId( 1 ) {
+  }
+
+  CompletionTracker::~CompletionTracker() {
+    Destroy();
+  }
+
+  bool CompletionTracker::Initialize( DeviceDispatch const & dispatch,
+                                      FencePool            & fence_pool ) {
+    Destroy();
+    Dispatch = &dispatch;
+    Fences = &fence_pool;
+    return true;
+  }
+
+  void CompletionTracker::Destroy() {
+    if( nullptr != Dispatch ) {
+      // Callbacks may free resources which are still in use by the device
+      WaitIdle();
+    }
+    PendingSubmissions.clear();
+    ReadyCallbacks.clear();
+    Dispatch = nullptr;
+    Fences = nullptr;
+    NextSubmissionId = 1;
+  }
+
+  bool CompletionTracker::BeginSubmission( VkFence  & fence,
+                                           uint64_t & submission_id ) {
+    submission_id = 0;
+    if( !Fences->Acquire( fence ) ) {
+      return false;
+    }
+    submission_id = NextSubmissionId++;
+    PendingSubmissions.push_back( { submission_id, fence, {} } );
+    return true;
+  }
+
+  void CompletionTracker::OnComplete( uint64_t              submission_id,
+                                      std::function<void()> callback ) {
+    // Callbacks are usually registered for the most recent submissions
+    for( auto submission = PendingSubmissions.rbegin(); submission != PendingSubmissions.rend(); ++submission ) {
+      if( submission->Id == submission_id ) {
+        submission->Callbacks.push_back( std::move( callback ) );
+        return;
+      }
+    }
+    ReadyCallbacks.push_back( std::move( callback ) );
+  }
+
+  void CompletionTracker::CancelSubmission( uint64_t submission_id ) {
+    for( size_t i = 0; i < PendingSubmissions.size(); ++i ) {
+      if( PendingSubmissions[i].Id == submission_id ) {
+        Complete( PendingSubmissions[i] );
+        PendingSubmissions.erase( PendingSubmissions.begin() + i );
+        return;
+      }
+    }
+  }
+
+  void CompletionTracker::Poll() {
+    for( size_t i = 0; i < PendingSubmissions.size(); ) {
+      VkResult result = Dispatch->vkGetFenceStatus( Dispatch->Device, PendingSubmissions[i].Fence );
+      if( VK_SUCCESS == result ) {
+        Complete( PendingSubmissions[i] );
+        PendingSubmissions.erase( PendingSubmissions.begin() + i );
+      } else {
+        if( VK_NOT_READY != result ) {
+          std::cout << "Could not get the status of a fence." << std::endl;
+        }
+        ++i;
+      }
+    }
+
+    // Callbacks may register new callbacks
+    std::vector<std::function<void()>> ready_callbacks;
+    ready_callbacks.swap( ReadyCallbacks );
+    for( auto & callback : ready_callbacks ) {
+      callback();
+    }
+  }
+
+  bool CompletionTracker::IsComplete( uint64_t submission_id ) const {
+    if( submission_id >= NextSubmissionId ) {
+      return false;
+    }
+    for( auto & submission : PendingSubmissions ) {
+      if( submission.Id == submission_id ) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool CompletionTracker::WaitForSubmission( uint64_t submission_id,
+                                             uint64_t timeout ) {
+    for( auto & submission : PendingSubmissions ) {
+      if( submission.Id == submission_id ) {
+        VkResult result = Dispatch->vkWaitForFences( Dispatch->Device, 1, &submission.Fence, VK_TRUE, timeout );
+        if( VK_TIMEOUT == result ) {
+          return false;
+        }
+        if( VK_SUCCESS != result ) {
+          std::cout << "Waiting on fence failed." << std::endl;
+          return false;
+        }
+        break;
+      }
+    }
+    Poll();
+    return IsComplete( submission_id );
+  }
+
+  bool CompletionTracker::WaitIdle() {
+    if( !PendingSubmissions.empty() ) {
+      std::vector<VkFence> fences;
+      for( auto & submission : PendingSubmissions ) {
+        fences.push_back( submission.Fence );
+      }
+      VkResult result = Dispatch->vkWaitForFences( Dispatch->Device, static_cast<uint32_t>(fences.size()), fences.data(), VK_TRUE, UINT64_MAX );
+      if( VK_SUCCESS != result ) {
+        std::cout << "Waiting on fence failed." << std::endl;
+        return false;
+      }
+    }
+    Poll();
+    return PendingSubmissions.empty();
+  }
+
+  void CompletionTracker::Complete( PendingSubmission & submission ) {
+    Fences->Release( submission.Fence );
+    for( auto & callback : submission.Callbacks ) {
+      ReadyCallbacks.push_back( std::move( callback ) );
+    }
+  }
+
+} // namespace VulkanCookbook
@@ -0,0 +1,268 @@
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Frame Loop
+
+#include "FrameLoop.h"
+#include "CommandBuffers.h"
+#include <algorithm>
+
+namespace VulkanCookbook {
+
+  FrameLoop::FrameLoop() :
+    Dispatch( nullptr ),
+    GraphicsQueue( VK_NULL_HANDLE ),
+    PresentQueue( VK_NULL_HANDLE ),
+    Batcher( nullptr ),
+    FrameIndex( 0 ),
+    SwapchainOutOfDate( false ) {
+  }
+
+  FrameLoop::~FrameLoop() {
+    Destroy();
+  }
+
+  bool FrameLoop::Initialize( DeviceDispatch const & dispatch,
+                              uint32_t               graphics_queue_family,
+                              VkQueue                graphics_queue,
+                              uint32_t               present_queue_family,
+                              VkQueue                present_queue,
+                              uint32_t               frames_in_flight,
+                              SubmitBatcher        * submit_batcher ) {
+    Destroy();
+
+    Dispatch = &dispatch;
+    GraphicsQueue = graphics_queue;
+    PresentQueue = present_queue;
+    QueueFamilies = { graphics_queue_family, present_queue_family };
+    Batcher = submit_batcher;
+    FrameIndex = 0;
+    SwapchainOutOfDate = false;
+    DestructionQueue.SetCurrentValue( FrameIndex + 1 );
+
+    InitVkDestroyer( *Dispatch, CommandPool );
+    if( !CreateCommandPool( *Dispatch, VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT, graphics_queue_family, *CommandPool ) ) {
+      return false;
+    }
+
+    std::vector<VkCommandBuffer> command_buffers;
+    if( !AllocateCommandBuffers( *Dispatch, *CommandPool, VK_COMMAND_BUFFER_LEVEL_PRIMARY, std::max( frames_in_flight, 1u ), command_buffers ) ) {
+      return false;
+    }
+
+    Frames.resize( command_buffers.size() );
+    for( size_t i = 0; i < Frames.size(); ++i ) {
+      FrameResources & frame = Frames[i];
+      frame.CommandBuffer = command_buffers[i];
+
+      InitVkDestroyer( *Dispatch, frame.ImageAcquiredSemaphore );
+      InitVkDestroyer( *Dispatch, frame.ReadyToPresentSemaphore );
+      InitVkDestroyer( *Dispatch, frame.DrawingFinishedFence );
+      // Fences start signaled so the first use of each frame does not block
+      if( !CreateSemaphore( *Dispatch, *frame.ImageAcquiredSemaphore ) ||
+          !CreateSemaphore( *Dispatch, *frame.ReadyToPresentSemaphore ) ||
+          !CreateFence( *Dispatch, true, *frame.DrawingFinishedFence ) ) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void FrameLoop::Destroy() {
+    if( nullptr == Dispatch ) {
+      return;
+    }
+    WaitForAllFrames();
+    RetiredSwapchains.clear();
+    DestructionQueue.DestroyAll();
+    Frames.clear();
+    CommandPool = VkDestroyer(VkCommandPool)();
+    Batcher = nullptr;
+    Dispatch = nullptr;
+  }
+
+  bool FrameLoop::RenderFrame( SwapchainState       & swapchain,
+                               RecordFunction const & record_command_buffer ) {
+    if( Frames.empty() ) {
+      return false;
+    }
+    FrameResources & frame = Frames[FrameIndex % Frames.size()];
+
+    if( !WaitForFences( *Dispatch, { *frame.DrawingFinishedFence }, VK_FALSE, UINT64_MAX ) ) {
+      return false;
+    }
+    ReleaseRetiredObjects();
+
+    if( SwapchainOutOfDate ||
+        !swapchain.Handle ) {
+      return true;
+    }
+
+    uint32_t image_index;
+    VkResult result = Dispatch->vkAcquireNextImageKHR( Dispatch->Device, *swapchain.Handle, UINT64_MAX, *frame.ImageAcquiredSemaphore, VK_NULL_HANDLE, &image_index );
+    switch( result ) {
+    case VK_SUCCESS:
+      break;
+    case VK_SUBOPTIMAL_KHR:
+      // The image is still presentable, recreate after this frame
+      SwapchainOutOfDate = true;
+      break;
+    case VK_ERROR_OUT_OF_DATE_KHR:
+      SwapchainOutOfDate = true;
+      return true;
+    default:
+      std::cout << "Could not acquire swapchain image." << std::endl;
+      return false;
+    }
+
+    WaitSemaphoreInfo wait_semaphore_info = {
+      *frame.ImageAcquiredSemaphore,                    // VkSemaphore            Semaphore
+      VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT     // VkPipelineStageFlags   WaitingStage
+    };
+
+    if( !BeginCommandBufferRecordingOperation( *Dispatch, frame.CommandBuffer, VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, nullptr ) ||
+        !record_command_buffer( frame.CommandBuffer, image_index ) ||
+        !EndCommandBufferRecordingOperation( *Dispatch, frame.CommandBuffer ) ) {
+      // Consume the acquire semaphore and signal the fence, so the frame can be
+      // waited on and reused
+      SubmitEmptyFrame( frame, wait_semaphore_info );
+      return false;
+    }
+
+    // Reset only once it is certain that the fence will be signaled again
+    if( !ResetFences( *Dispatch, { *frame.DrawingFinishedFence } ) ) {
+      return false;
+    }
+    if( nullptr != Batcher ) {
+      SubmitBatch batch;
+      batch.WaitSemaphores.push_back( { wait_semaphore_info.Semaphore, 0, wait_semaphore_info.WaitingStage } );
+      batch.CommandBuffers.push_back( frame.CommandBuffer );
+      batch.SignalSemaphores.push_back( { *frame.ReadyToPresentSemaphore, 0 } );
+      Batcher->Add( GraphicsQueue, batch );
+
+      // Other queues may signal semaphores the frame waits on, so flush all of them
+      bool fence_submitted = false;
+      if( !Batcher->FlushAll( GraphicsQueue, *frame.DrawingFinishedFence, &fence_submitted ) ) {
+        if( !fence_submitted ) {
+          SubmitEmptyFrame( frame, wait_semaphore_info );
+        }
+        return false;
+      }
+    } else if( !SubmitCommandBuffersToQueue( *Dispatch, GraphicsQueue, { wait_semaphore_info }, { frame.CommandBuffer }, { *frame.ReadyToPresentSemaphore }, *frame.DrawingFinishedFence ) ) {
+      SubmitEmptyFrame( frame, wait_semaphore_info );
+      return false;
+    }
+
+    VkPresentInfoKHR present_info = {
+      VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,   // VkStructureType          sType
+      nullptr,                              // const void             * pNext
+      1,                                    // uint32_t                 waitSemaphoreCount
+      &*frame.ReadyToPresentSemaphore,      // const VkSemaphore      * pWaitSemaphores
+      1,                                    // uint32_t                 swapchainCount
+      &*swapchain.Handle,                   // const VkSwapchainKHR   * pSwapchains
+      &image_index,                         // const uint32_t         * pImageIndices
+      nullptr                               // VkResult               * pResults
+    };
+
+    ++FrameIndex;
+    DestructionQueue.SetCurrentValue( FrameIndex + 1 );
+
+    result = Dispatch->vkQueuePresentKHR( PresentQueue, &present_info );
+    switch( result ) {
+    case VK_SUCCESS:
+      return true;
+    case VK_SUBOPTIMAL_KHR:
+    case VK_ERROR_OUT_OF_DATE_KHR:
+      SwapchainOutOfDate = true;
+      return true;
+    default:
+      std::cout << "Could not present swapchain image." << std::endl;
+      return false;
+    }
+  }
+
+  bool FrameLoop::SubmitEmptyFrame( FrameResources          & frame,
+                                    WaitSemaphoreInfo const & wait_semaphore_info ) {
+    // The fence is either still signaled or was reset right before a failed
+    // submission, in which case nothing will signal it
+    if( !ResetFences( *Dispatch, { *frame.DrawingFinishedFence } ) ) {
+      return false;
+    }
+    if( !SubmitCommandBuffersToQueue( *Dispatch, GraphicsQueue, { wait_semaphore_info }, {}, {}, *frame.DrawingFinishedFence ) ) {
+      // Nothing will wait on the semaphore or signal the fence anymore, so
+      // replace both instead of blocking on them later
+      InitVkDestroyer( *Dispatch, frame.ImageAcquiredSemaphore );
+      InitVkDestroyer( *Dispatch, frame.DrawingFinishedFence );
+      CreateSemaphore( *Dispatch, *frame.ImageAcquiredSemaphore );
+      CreateFence( *Dispatch, true, *frame.DrawingFinishedFence );
+      return false;
+    }
+    return true;
+  }
+
+  bool FrameLoop::RecreateSwapchain( VkPhysicalDevice    physical_device,
+                                     VkSurfaceKHR        presentation_surface,
+                                     uint32_t            image_count,
+                                     VkPresentModeKHR    present_mode,
+                                     VkImageUsageFlags   image_usage,
+                                     SwapchainState    & swapchain ) {
+    SwapchainState old_swapchain = std::move( swapchain );
+    if( !CreateSwapchainWithImageViews( physical_device, *Dispatch, presentation_surface, image_count, present_mode, image_usage, *old_swapchain.Handle, QueueFamilies, swapchain ) ) {
+      // Usually a minimized window - keep the old swapchain and try again later
+      swapchain = std::move( old_swapchain );
+      return false;
+    }
+    SwapchainOutOfDate = false;
+
+    // Frames up to the current index may still reference the old images
+    if( old_swapchain.Handle ) {
+      RetiredSwapchains.push_back( { std::move( old_swapchain ), FrameIndex } );
+    }
+    return true;
+  }
+
+  void FrameLoop::ReleaseRetiredObjects() {
+    // All frames before FrameIndex - frames in flight + 1 have finished, as the
+    // fence of the frame that reuses their resources was just waited on
+    uint64_t frames_in_flight = Frames.size();
+    auto first_in_use = std::remove_if( RetiredSwapchains.begin(), RetiredSwapchains.end(), [&]( RetiredSwapchain const & retired ) {
+      return retired.LastFrameIndex + frames_in_flight <= FrameIndex + 1;
+    } );
+    RetiredSwapchains.erase( first_in_use, RetiredSwapchains.end() );
+
+    if( FrameIndex + 1 >= frames_in_flight ) {
+      DestructionQueue.Collect( FrameIndex + 1 - frames_in_flight );
+    }
+  }
+
+  bool FrameLoop::WaitForAllFrames() {
+    std::vector<VkFence> fences;
+    for( auto & frame : Frames ) {
+      if( frame.DrawingFinishedFence ) {
+        fences.push_back( *frame.DrawingFinishedFence );
+      }
+    }
+    if( fences.empty() ) {
+      return true;
+    }
+    return WaitForFences( *Dispatch, fences, VK_TRUE, UINT64_MAX );
+  }
+
+} // namespace VulkanCookbook
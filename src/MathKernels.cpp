@@ -0,0 +1,675 @@
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Math Kernels
+
+#include "MathKernels.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <mutex>
+
+#if defined _M_X64 || defined _M_IX86 || defined __x86_64__ || defined __i386__
+#define MATH_KERNELS_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define MATH_KERNELS_TARGET_SSE
+#define MATH_KERNELS_TARGET_AVX2
+#define MATH_KERNELS_INLINE __forceinline
+#else
+#define MATH_KERNELS_TARGET_SSE __attribute__(( target( "sse2" ) ))
+#define MATH_KERNELS_TARGET_AVX2 __attribute__(( target( "avx2" ) ))
+#define MATH_KERNELS_INLINE inline __attribute__(( always_inline ))
+#endif
+#endif
+
+namespace VulkanCookbook {
+
+  namespace {
+
+    struct MathKernelTable {
+      void (*MultiplyMatrices)( Matrix4x4 const &, Matrix4x4 const *, Matrix4x4 *, size_t );
+      void (*TransformVectors)( Matrix4x4 const &, Vector3 const *, Vector3 *, size_t );
+      void (*NormalizeVectors)( Vector3 const *, Vector3 *, size_t );
+      void (*TransformPositionsSoA)( Matrix4x4 const &, float const *, float const *, float const *, float *, float *, float *, float *, size_t );
+    };
+
+    // Smaller chunks are not worth the cost of a task
+    size_t const MinimalPositionChunkSize = 16 * 1024;
+
+    // Scalar
+
+    void MultiplyMatricesScalar( Matrix4x4 const & left,
+                                 Matrix4x4 const * rights,
+                                 Matrix4x4       * results,
+                                 size_t            count ) {
+      for( size_t i = 0; i < count; ++i ) {
+        results[i] = left * rights[i];
+      }
+    }
+
+    void TransformVectorsScalar( Matrix4x4 const & matrix,
+                                 Vector3 const   * vectors,
+                                 Vector3         * results,
+                                 size_t            count ) {
+      for( size_t i = 0; i < count; ++i ) {
+        results[i] = vectors[i] * matrix;
+      }
+    }
+
+    void NormalizeVectorsScalar( Vector3 const * vectors,
+                                 Vector3       * results,
+                                 size_t          count ) {
+      for( size_t i = 0; i < count; ++i ) {
+        results[i] = Normalize( vectors[i] );
+      }
+    }
+
+    void TransformPositionsSoAScalar( Matrix4x4 const & matrix,
+                                      float const     * xs,
+                                      float const     * ys,
+                                      float const     * zs,
+                                      float           * result_xs,
+                                      float           * result_ys,
+                                      float           * result_zs,
+                                      float           * result_ws,
+                                      size_t            count ) {
+      for( size_t i = 0; i < count; ++i ) {
+        float x = xs[i];
+        float y = ys[i];
+        float z = zs[i];
+        result_xs[i] = matrix[0] * x + matrix[4] * y + matrix[8] * z + matrix[12];
+        result_ys[i] = matrix[1] * x + matrix[5] * y + matrix[9] * z + matrix[13];
+        result_zs[i] = matrix[2] * x + matrix[6] * y + matrix[10] * z + matrix[14];
+        if( nullptr != result_ws ) {
+          result_ws[i] = matrix[3] * x + matrix[7] * y + matrix[11] * z + matrix[15];
+        }
+      }
+    }
+
+#ifdef MATH_KERNELS_X86
+
+    // Vector3 arrays are converted between 4 (or 2 x 4) packed vectors and
+    // x, y, z registers. The order of vectors inside the registers differs
+    // from memory order, which does not matter for per-vector operations.
+
+    // SSE
+
+    MATH_KERNELS_TARGET_SSE MATH_KERNELS_INLINE void LoadVectorsSSE( float const * source,
+                                                                     __m128      & x,
+                                                                     __m128      & y,
+                                                                     __m128      & z ) {
+      __m128 m0 = _mm_loadu_ps( source );
+      __m128 m1 = _mm_loadu_ps( source + 4 );
+      __m128 m2 = _mm_loadu_ps( source + 8 );
+      __m128 xy = _mm_shuffle_ps( m1, m2, _MM_SHUFFLE( 2, 1, 3, 2 ) );
+      __m128 yz = _mm_shuffle_ps( m0, m1, _MM_SHUFFLE( 1, 0, 2, 1 ) );
+      x = _mm_shuffle_ps( m0, xy, _MM_SHUFFLE( 2, 0, 3, 0 ) );
+      y = _mm_shuffle_ps( yz, xy, _MM_SHUFFLE( 3, 1, 2, 0 ) );
+      z = _mm_shuffle_ps( yz, m2, _MM_SHUFFLE( 3, 0, 3, 1 ) );
+    }
+
+    MATH_KERNELS_TARGET_SSE MATH_KERNELS_INLINE void StoreVectorsSSE( __m128   x,
+                                                                      __m128   y,
+                                                                      __m128   z,
+                                                                      float  * destination ) {
+      __m128 xy = _mm_shuffle_ps( x, y, _MM_SHUFFLE( 2, 0, 2, 0 ) );
+      __m128 yz = _mm_shuffle_ps( y, z, _MM_SHUFFLE( 3, 1, 3, 1 ) );
+      __m128 zx = _mm_shuffle_ps( z, x, _MM_SHUFFLE( 3, 1, 2, 0 ) );
+      _mm_storeu_ps( destination, _mm_shuffle_ps( xy, zx, _MM_SHUFFLE( 2, 0, 2, 0 ) ) );
+      _mm_storeu_ps( destination + 4, _mm_shuffle_ps( yz, xy, _MM_SHUFFLE( 3, 1, 2, 0 ) ) );
+      _mm_storeu_ps( destination + 8, _mm_shuffle_ps( zx, yz, _MM_SHUFFLE( 3, 1, 3, 1 ) ) );
+    }
+
+    MATH_KERNELS_TARGET_SSE void MultiplyMatricesSSE( Matrix4x4 const & left,
+                                                      Matrix4x4 const * rights,
+                                                      Matrix4x4       * results,
+                                                      size_t            count ) {
+      __m128 column0 = _mm_loadu_ps( &left[0] );
+      __m128 column1 = _mm_loadu_ps( &left[4] );
+      __m128 column2 = _mm_loadu_ps( &left[8] );
+      __m128 column3 = _mm_loadu_ps( &left[12] );
+
+      for( size_t i = 0; i < count; ++i ) {
+        __m128 columns[4];
+        for( int column = 0; column < 4; ++column ) {
+          __m128 right = _mm_loadu_ps( &rights[i][4 * column] );
+          __m128 result = _mm_mul_ps( column0, _mm_shuffle_ps( right, right, _MM_SHUFFLE( 0, 0, 0, 0 ) ) );
+          result = _mm_add_ps( result, _mm_mul_ps( column1, _mm_shuffle_ps( right, right, _MM_SHUFFLE( 1, 1, 1, 1 ) ) ) );
+          result = _mm_add_ps( result, _mm_mul_ps( column2, _mm_shuffle_ps( right, right, _MM_SHUFFLE( 2, 2, 2, 2 ) ) ) );
+          result = _mm_add_ps( result, _mm_mul_ps( column3, _mm_shuffle_ps( right, right, _MM_SHUFFLE( 3, 3, 3, 3 ) ) ) );
+          columns[column] = result;
+        }
+        // Stored only now, so results may alias rights
+        for( int column = 0; column < 4; ++column ) {
+          _mm_storeu_ps( &results[i][4 * column], columns[column] );
+        }
+      }
+    }
+
+    MATH_KERNELS_TARGET_SSE void TransformVectorsSSE( Matrix4x4 const & matrix,
+                                                      Vector3 const   * vectors,
+                                                      Vector3         * results,
+                                                      size_t            count ) {
+      __m128 m[9];
+      for( int row = 0; row < 3; ++row ) {
+        for( int column = 0; column < 3; ++column ) {
+          m[3 * row + column] = _mm_set1_ps( matrix[4 * row + column] );
+        }
+      }
+
+      size_t i = 0;
+      for( ; i + 4 <= count; i += 4 ) {
+        __m128 x, y, z;
+        LoadVectorsSSE( vectors[i].data(), x, y, z );
+
+        __m128 rx = _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, m[0] ), _mm_mul_ps( y, m[1] ) ), _mm_mul_ps( z, m[2] ) );
+        __m128 ry = _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, m[3] ), _mm_mul_ps( y, m[4] ) ), _mm_mul_ps( z, m[5] ) );
+        __m128 rz = _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, m[6] ), _mm_mul_ps( y, m[7] ) ), _mm_mul_ps( z, m[8] ) );
+
+        StoreVectorsSSE( rx, ry, rz, results[i].data() );
+      }
+      TransformVectorsScalar( matrix, vectors + i, results + i, count - i );
+    }
+
+    MATH_KERNELS_TARGET_SSE void NormalizeVectorsSSE( Vector3 const * vectors,
+                                                      Vector3       * results,
+                                                      size_t          count ) {
+      size_t i = 0;
+      for( ; i + 4 <= count; i += 4 ) {
+        __m128 x, y, z;
+        LoadVectorsSSE( vectors[i].data(), x, y, z );
+
+        __m128 length = _mm_sqrt_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, x ), _mm_mul_ps( y, y ) ), _mm_mul_ps( z, z ) ) );
+
+        StoreVectorsSSE( _mm_div_ps( x, length ), _mm_div_ps( y, length ), _mm_div_ps( z, length ), results[i].data() );
+      }
+      NormalizeVectorsScalar( vectors + i, results + i, count - i );
+    }
+
+    MATH_KERNELS_TARGET_SSE void TransformPositionsSoASSE( Matrix4x4 const & matrix,
+                                                           float const     * xs,
+                                                           float const     * ys,
+                                                           float const     * zs,
+                                                           float           * result_xs,
+                                                           float           * result_ys,
+                                                           float           * result_zs,
+                                                           float           * result_ws,
+                                                           size_t            count ) {
+      __m128 m[16];
+      for( int element = 0; element < 16; ++element ) {
+        m[element] = _mm_set1_ps( matrix[element] );
+      }
+
+      size_t i = 0;
+      for( ; i + 4 <= count; i += 4 ) {
+        __m128 x = _mm_loadu_ps( xs + i );
+        __m128 y = _mm_loadu_ps( ys + i );
+        __m128 z = _mm_loadu_ps( zs + i );
+        _mm_storeu_ps( result_xs + i, _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( m[0], x ), _mm_mul_ps( m[4], y ) ), _mm_mul_ps( m[8], z ) ), m[12] ) );
+        _mm_storeu_ps( result_ys + i, _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( m[1], x ), _mm_mul_ps( m[5], y ) ), _mm_mul_ps( m[9], z ) ), m[13] ) );
+        _mm_storeu_ps( result_zs + i, _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( m[2], x ), _mm_mul_ps( m[6], y ) ), _mm_mul_ps( m[10], z ) ), m[14] ) );
+        if( nullptr != result_ws ) {
+          _mm_storeu_ps( result_ws + i, _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( m[3], x ), _mm_mul_ps( m[7], y ) ), _mm_mul_ps( m[11], z ) ), m[15] ) );
+        }
+      }
+      TransformPositionsSoAScalar( matrix, xs + i, ys + i, zs + i, result_xs + i, result_ys + i, result_zs + i, (nullptr != result_ws) ? result_ws + i : nullptr, count - i );
+    }
+
+    // AVX2
+
+    // Same shuffles as in SSE - they work per 128-bit lane. Vectors 0 - 3 go
+    // to the lower and 4 - 7 to the upper lanes.
+    MATH_KERNELS_TARGET_AVX2 MATH_KERNELS_INLINE void LoadVectorsAVX( float const * source,
+                                                                      __m256      & x,
+                                                                      __m256      & y,
+                                                                      __m256      & z ) {
+      __m256 m0 = _mm256_insertf128_ps( _mm256_castps128_ps256( _mm_loadu_ps( source ) ), _mm_loadu_ps( source + 12 ), 1 );
+      __m256 m1 = _mm256_insertf128_ps( _mm256_castps128_ps256( _mm_loadu_ps( source + 4 ) ), _mm_loadu_ps( source + 16 ), 1 );
+      __m256 m2 = _mm256_insertf128_ps( _mm256_castps128_ps256( _mm_loadu_ps( source + 8 ) ), _mm_loadu_ps( source + 20 ), 1 );
+      __m256 xy = _mm256_shuffle_ps( m1, m2, _MM_SHUFFLE( 2, 1, 3, 2 ) );
+      __m256 yz = _mm256_shuffle_ps( m0, m1, _MM_SHUFFLE( 1, 0, 2, 1 ) );
+      x = _mm256_shuffle_ps( m0, xy, _MM_SHUFFLE( 2, 0, 3, 0 ) );
+      y = _mm256_shuffle_ps( yz, xy, _MM_SHUFFLE( 3, 1, 2, 0 ) );
+      z = _mm256_shuffle_ps( yz, m2, _MM_SHUFFLE( 3, 0, 3, 1 ) );
+    }
+
+    MATH_KERNELS_TARGET_AVX2 MATH_KERNELS_INLINE void StoreVectorsAVX( __m256   x,
+                                                                       __m256   y,
+                                                                       __m256   z,
+                                                                       float  * destination ) {
+      __m256 xy = _mm256_shuffle_ps( x, y, _MM_SHUFFLE( 2, 0, 2, 0 ) );
+      __m256 yz = _mm256_shuffle_ps( y, z, _MM_SHUFFLE( 3, 1, 3, 1 ) );
+      __m256 zx = _mm256_shuffle_ps( z, x, _MM_SHUFFLE( 3, 1, 2, 0 ) );
+      __m256 m0 = _mm256_shuffle_ps( xy, zx, _MM_SHUFFLE( 2, 0, 2, 0 ) );
+      __m256 m1 = _mm256_shuffle_ps( yz, xy, _MM_SHUFFLE( 3, 1, 2, 0 ) );
+      __m256 m2 = _mm256_shuffle_ps( zx, yz, _MM_SHUFFLE( 3, 1, 3, 1 ) );
+      _mm_storeu_ps( destination, _mm256_castps256_ps128( m0 ) );
+      _mm_storeu_ps( destination + 4, _mm256_castps256_ps128( m1 ) );
+      _mm_storeu_ps( destination + 8, _mm256_castps256_ps128( m2 ) );
+      _mm_storeu_ps( destination + 12, _mm256_extractf128_ps( m0, 1 ) );
+      _mm_storeu_ps( destination + 16, _mm256_extractf128_ps( m1, 1 ) );
+      _mm_storeu_ps( destination + 20, _mm256_extractf128_ps( m2, 1 ) );
+    }
+
+    MATH_KERNELS_TARGET_AVX2 void MultiplyMatricesAVX2( Matrix4x4 const & left,
+                                                        Matrix4x4 const * rights,
+                                                        Matrix4x4       * results,
+                                                        size_t            count ) {
+      // Two columns of the result at once - one per 128-bit lane
+      __m256 column0 = _mm256_broadcast_ps( reinterpret_cast<__m128 const *>(&left[0]) );
+      __m256 column1 = _mm256_broadcast_ps( reinterpret_cast<__m128 const *>(&left[4]) );
+      __m256 column2 = _mm256_broadcast_ps( reinterpret_cast<__m128 const *>(&left[8]) );
+      __m256 column3 = _mm256_broadcast_ps( reinterpret_cast<__m128 const *>(&left[12]) );
+
+      for( size_t i = 0; i < count; ++i ) {
+        __m256 right01 = _mm256_loadu_ps( &rights[i][0] );
+        __m256 right23 = _mm256_loadu_ps( &rights[i][8] );
+        __m256 columns[2];
+        __m256 rights_pair[2] = { right01, right23 };
+        for( int pair = 0; pair < 2; ++pair ) {
+          __m256 right = rights_pair[pair];
+          __m256 result = _mm256_mul_ps( column0, _mm256_shuffle_ps( right, right, _MM_SHUFFLE( 0, 0, 0, 0 ) ) );
+          result = _mm256_add_ps( result, _mm256_mul_ps( column1, _mm256_shuffle_ps( right, right, _MM_SHUFFLE( 1, 1, 1, 1 ) ) ) );
+          result = _mm256_add_ps( result, _mm256_mul_ps( column2, _mm256_shuffle_ps( right, right, _MM_SHUFFLE( 2, 2, 2, 2 ) ) ) );
+          result = _mm256_add_ps( result, _mm256_mul_ps( column3, _mm256_shuffle_ps( right, right, _MM_SHUFFLE( 3, 3, 3, 3 ) ) ) );
+          columns[pair] = result;
+        }
+        _mm256_storeu_ps( &results[i][0], columns[0] );
+        _mm256_storeu_ps( &results[i][8], columns[1] );
+      }
+    }
+
+    MATH_KERNELS_TARGET_AVX2 void TransformVectorsAVX2( Matrix4x4 const & matrix,
+                                                        Vector3 const   * vectors,
+                                                        Vector3         * results,
+                                                        size_t            count ) {
+      __m256 m[9];
+      for( int row = 0; row < 3; ++row ) {
+        for( int column = 0; column < 3; ++column ) {
+          m[3 * row + column] = _mm256_set1_ps( matrix[4 * row + column] );
+        }
+      }
+
+      size_t i = 0;
+      for( ; i + 8 <= count; i += 8 ) {
+        __m256 x, y, z;
+        LoadVectorsAVX( vectors[i].data(), x, y, z );
+
+        __m256 rx = _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( x, m[0] ), _mm256_mul_ps( y, m[1] ) ), _mm256_mul_ps( z, m[2] ) );
+        __m256 ry = _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( x, m[3] ), _mm256_mul_ps( y, m[4] ) ), _mm256_mul_ps( z, m[5] ) );
+        __m256 rz = _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( x, m[6] ), _mm256_mul_ps( y, m[7] ) ), _mm256_mul_ps( z, m[8] ) );
+
+        StoreVectorsAVX( rx, ry, rz, results[i].data() );
+      }
+      TransformVectorsScalar( matrix, vectors + i, results + i, count - i );
+    }
+
+    MATH_KERNELS_TARGET_AVX2 void NormalizeVectorsAVX2( Vector3 const * vectors,
+                                                        Vector3       * results,
+                                                        size_t          count ) {
+      size_t i = 0;
+      for( ; i + 8 <= count; i += 8 ) {
+        __m256 x, y, z;
+        LoadVectorsAVX( vectors[i].data(), x, y, z );
+
+        __m256 length = _mm256_sqrt_ps( _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( x, x ), _mm256_mul_ps( y, y ) ), _mm256_mul_ps( z, z ) ) );
+
+        StoreVectorsAVX( _mm256_div_ps( x, length ), _mm256_div_ps( y, length ), _mm256_div_ps( z, length ), results[i].data() );
+      }
+      NormalizeVectorsScalar( vectors + i, results + i, count - i );
+    }
+
+    MATH_KERNELS_TARGET_AVX2 void TransformPositionsSoAAVX2( Matrix4x4 const & matrix,
+                                                             float const     * xs,
+                                                             float const     * ys,
+                                                             float const     * zs,
+                                                             float           * result_xs,
+                                                             float           * result_ys,
+                                                             float           * result_zs,
+                                                             float           * result_ws,
+                                                             size_t            count ) {
+      __m256 m[16];
+      for( int element = 0; element < 16; ++element ) {
+        m[element] = _mm256_set1_ps( matrix[element] );
+      }
+
+      size_t i = 0;
+      for( ; i + 8 <= count; i += 8 ) {
+        __m256 x = _mm256_loadu_ps( xs + i );
+        __m256 y = _mm256_loadu_ps( ys + i );
+        __m256 z = _mm256_loadu_ps( zs + i );
+        _mm256_storeu_ps( result_xs + i, _mm256_add_ps( _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( m[0], x ), _mm256_mul_ps( m[4], y ) ), _mm256_mul_ps( m[8], z ) ), m[12] ) );
+        _mm256_storeu_ps( result_ys + i, _mm256_add_ps( _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( m[1], x ), _mm256_mul_ps( m[5], y ) ), _mm256_mul_ps( m[9], z ) ), m[13] ) );
+        _mm256_storeu_ps( result_zs + i, _mm256_add_ps( _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( m[2], x ), _mm256_mul_ps( m[6], y ) ), _mm256_mul_ps( m[10], z ) ), m[14] ) );
+        if( nullptr != result_ws ) {
+          _mm256_storeu_ps( result_ws + i, _mm256_add_ps( _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( m[3], x ), _mm256_mul_ps( m[7], y ) ), _mm256_mul_ps( m[11], z ) ), m[15] ) );
+        }
+      }
+      TransformPositionsSoAScalar( matrix, xs + i, ys + i, zs + i, result_xs + i, result_ys + i, result_zs + i, (nullptr != result_ws) ? result_ws + i : nullptr, count - i );
+    }
+
+    bool IsAVX2Supported() {
+#ifdef _MSC_VER
+      int info[4];
+      __cpuid( info, 0 );
+      if( info[0] < 7 ) {
+        return false;
+      }
+      __cpuid( info, 1 );
+      bool os_saves_avx_state = (0 != (info[2] & (1 << 27))) &&
+                                (6 == (_xgetbv( 0 ) & 6));
+      __cpuidex( info, 7, 0 );
+      return os_saves_avx_state && (0 != (info[1] & (1 << 5)));
+#else
+      // Also checks that the OS saves the AVX state
+      return 0 != __builtin_cpu_supports( "avx2" );
+#endif
+    }
+
+    bool IsSSESupported() {
+#if defined _M_X64 || defined __x86_64__
+      return true;
+#elif defined _MSC_VER
+      int info[4];
+      __cpuid( info, 1 );
+      return 0 != (info[3] & (1 << 26));
+#else
+      return 0 != __builtin_cpu_supports( "sse2" );
+#endif
+    }
+
+#endif // MATH_KERNELS_X86
+
+    bool IsMathKernelSetSupported( MathKernelSet kernel_set ) {
+      switch( kernel_set ) {
+      case MathKernelSet::Scalar:
+        return true;
+#ifdef MATH_KERNELS_X86
+      case MathKernelSet::SSE:
+        return IsSSESupported();
+      case MathKernelSet::AVX2:
+        return IsAVX2Supported();
+#endif
+      default:
+        return false;
+      }
+    }
+
+    MathKernelTable GetMathKernelTable( MathKernelSet kernel_set ) {
+      switch( kernel_set ) {
+#ifdef MATH_KERNELS_X86
+      case MathKernelSet::SSE:
+        return { MultiplyMatricesSSE, TransformVectorsSSE, NormalizeVectorsSSE, TransformPositionsSoASSE };
+      case MathKernelSet::AVX2:
+        return { MultiplyMatricesAVX2, TransformVectorsAVX2, NormalizeVectorsAVX2, TransformPositionsSoAAVX2 };
+#endif
+      default:
+        return { MultiplyMatricesScalar, TransformVectorsScalar, NormalizeVectorsScalar, TransformPositionsSoAScalar };
+      }
+    }
+
+    std::atomic<MathKernelSet> ActiveKernelSet( MathKernelSet::Scalar );
+    MathKernelTable ActiveKernels = GetMathKernelTable( MathKernelSet::Scalar );
+    std::once_flag KernelSelection;
+
+    MathKernelTable const & GetActiveKernels() {
+      std::call_once( KernelSelection, []() {
+        for( auto kernel_set : { MathKernelSet::AVX2, MathKernelSet::SSE } ) {
+          if( IsMathKernelSetSupported( kernel_set ) ) {
+            ActiveKernels = GetMathKernelTable( kernel_set );
+            ActiveKernelSet = kernel_set;
+            break;
+          }
+        }
+      } );
+      return ActiveKernels;
+    }
+
+    // Average time of one call. Best of several runs filters out noise from other processes
+    template<class Function>
+    double MeasureMicroseconds( Function function ) {
+      int const repetitions = 100;
+      double best = 0.0;
+      for( int run = 0; run < 5; ++run ) {
+        auto begin = std::chrono::steady_clock::now();
+        for( int repetition = 0; repetition < repetitions; ++repetition ) {
+          function();
+        }
+        double duration = std::chrono::duration<double, std::micro>( std::chrono::steady_clock::now() - begin ).count() / repetitions;
+        best = (0 == run) ? duration : std::min( best, duration );
+      }
+      return best;
+    }
+
+  } // namespace
+
+  MathKernelSet GetMathKernelSet() {
+    GetActiveKernels();
+    return ActiveKernelSet;
+  }
+
+  char const * GetMathKernelSetName( MathKernelSet kernel_set ) {
+    switch( kernel_set ) {
+    case MathKernelSet::SSE:
+      return "SSE";
+    case MathKernelSet::AVX2:
+      return "AVX2";
+    default:
+      return "scalar";
+    }
+  }
+
+  // Not synchronized with kernels running on other threads
+  bool SetMathKernelSet( MathKernelSet kernel_set ) {
+    GetActiveKernels();
+    if( !IsMathKernelSetSupported( kernel_set ) ) {
+      return false;
+    }
+    ActiveKernels = GetMathKernelTable( kernel_set );
+    ActiveKernelSet = kernel_set;
+    return true;
+  }
+
+  void MultiplyMatrices( Matrix4x4 const & left,
+                         Matrix4x4 const * rights,
+                         Matrix4x4       * results,
+                         size_t            count ) {
+    GetActiveKernels().MultiplyMatrices( left, rights, results, count );
+  }
+
+  void TransformVectors( Matrix4x4 const & matrix,
+                         Vector3 const   * vectors,
+                         Vector3         * results,
+                         size_t            count ) {
+    GetActiveKernels().TransformVectors( matrix, vectors, results, count );
+  }
+
+  void NormalizeVectors( Vector3 const * vectors,
+                         Vector3       * results,
+                         size_t          count ) {
+    GetActiveKernels().NormalizeVectors( vectors, results, count );
+  }
+
+  void TransformPositionsSoA( Matrix4x4 const & matrix,
+                              float const     * xs,
+                              float const     * ys,
+                              float const     * zs,
+                              float           * result_xs,
+                              float           * result_ys,
+                              float           * result_zs,
+                              float           * result_ws,
+                              size_t            count ) {
+    GetActiveKernels().TransformPositionsSoA( matrix, xs, ys, zs, result_xs, result_ys, result_zs, result_ws, count );
+  }
+
+  void TransformPositionsSoA( ThreadPool      & thread_pool,
+                              Matrix4x4 const & matrix,
+                              float const     * xs,
+                              float const     * ys,
+                              float const     * zs,
+                              float           * result_xs,
+                              float           * result_ys,
+                              float           * result_zs,
+                              float           * result_ws,
+                              size_t            count ) {
+    auto kernel = GetActiveKernels().TransformPositionsSoA;
+
+    size_t chunk_count = std::min<size_t>( count / MinimalPositionChunkSize, thread_pool.GetThreadCount() );
+    if( chunk_count <= 1 ) {
+      kernel( matrix, xs, ys, zs, result_xs, result_ys, result_zs, result_ws, count );
+      return;
+    }
+    // Multiple of 16 floats, so chunks start on cache line boundaries of aligned streams
+    size_t chunk_size = ((count + chunk_count - 1) / chunk_count + 15) & ~size_t( 15 );
+
+    std::vector<std::future<void>> tasks;
+    for( size_t begin = 0; begin < count; begin += chunk_size ) {
+      size_t size = std::min( chunk_size, count - begin );
+      tasks.push_back( thread_pool.Submit( [=, &matrix]( uint32_t ) {
+        kernel( matrix, xs + begin, ys + begin, zs + begin, result_xs + begin, result_ys + begin, result_zs + begin, (nullptr != result_ws) ? result_ws + begin : nullptr, size );
+      } ) );
+    }
+    for( auto & task : tasks ) {
+      task.get();
+    }
+  }
+
+  void BenchmarkMathKernels() {
+    // Small enough to stay in cache, so the kernels are measured instead of memory bandwidth
+    size_t const vector_count = 16 * 1024;
+    size_t const matrix_count = 4 * 1024;
+
+    // Deterministic, non-trivial input
+    uint32_t seed = 12345;
+    auto random = [&seed]() {
+      seed = seed * 1664525u + 1013904223u;
+      return static_cast<float>(seed >> 8) / static_cast<float>(1 << 24) * 2.0f - 1.0f;
+    };
+    std::vector<Vector3> vectors( vector_count );
+    for( auto & vector : vectors ) {
+      vector = { random(), random(), random() };
+    }
+    std::vector<Matrix4x4> matrices( matrix_count );
+    for( auto & matrix : matrices ) {
+      for( auto & element : matrix ) {
+        element = random();
+      }
+    }
+    Matrix4x4 transform;
+    for( auto & element : transform ) {
+      element = random();
+    }
+    std::vector<float> xs( vector_count );
+    std::vector<float> ys( vector_count );
+    std::vector<float> zs( vector_count );
+    for( size_t i = 0; i < vector_count; ++i ) {
+      xs[i] = vectors[i][0];
+      ys[i] = vectors[i][1];
+      zs[i] = vectors[i][2];
+    }
+
+    // Reference results come from the Tools.h operators
+    std::vector<Vector3> reference_transformed( vector_count );
+    std::vector<Vector3> reference_normalized( vector_count );
+    std::vector<Matrix4x4> reference_matrices( matrix_count );
+    double reference_transform_time = MeasureMicroseconds( [&]() {
+      for( size_t i = 0; i < vector_count; ++i ) {
+        reference_transformed[i] = vectors[i] * transform;
+      }
+    } );
+    double reference_normalize_time = MeasureMicroseconds( [&]() {
+      for( size_t i = 0; i < vector_count; ++i ) {
+        reference_normalized[i] = Normalize( vectors[i] );
+      }
+    } );
+    double reference_multiply_time = MeasureMicroseconds( [&]() {
+      for( size_t i = 0; i < matrix_count; ++i ) {
+        reference_matrices[i] = transform * matrices[i];
+      }
+    } );
+    std::vector<float> reference_positions( 4 * vector_count );
+    TransformPositionsSoAScalar( transform, xs.data(), ys.data(), zs.data(), &reference_positions[0], &reference_positions[vector_count], &reference_positions[2 * vector_count], &reference_positions[3 * vector_count], vector_count );
+
+    std::cout << "Math kernels: " << vector_count << " vectors, " << matrix_count << " matrices" << std::endl;
+    std::cout << "  " << std::left << std::setw( 12 ) << "operators" << "transform " << reference_transform_time << " us, normalize " << reference_normalize_time << " us, matrix multiply " << reference_multiply_time << " us" << std::endl;
+
+    MathKernelSet previous_kernel_set = GetMathKernelSet();
+    std::vector<Vector3> transformed( vector_count );
+    std::vector<Vector3> normalized( vector_count );
+    std::vector<Matrix4x4> multiplied( matrix_count );
+    std::vector<float> positions( 4 * vector_count );
+    for( auto kernel_set : { MathKernelSet::Scalar, MathKernelSet::SSE, MathKernelSet::AVX2 } ) {
+      if( !SetMathKernelSet( kernel_set ) ) {
+        std::cout << "  " << GetMathKernelSetName( kernel_set ) << " is not supported" << std::endl;
+        continue;
+      }
+      double transform_time = MeasureMicroseconds( [&]() {
+        TransformVectors( transform, vectors.data(), transformed.data(), vector_count );
+      } );
+      double normalize_time = MeasureMicroseconds( [&]() {
+        NormalizeVectors( vectors.data(), normalized.data(), vector_count );
+      } );
+      double multiply_time = MeasureMicroseconds( [&]() {
+        MultiplyMatrices( transform, matrices.data(), multiplied.data(), matrix_count );
+      } );
+      double positions_time = MeasureMicroseconds( [&]() {
+        TransformPositionsSoA( transform, xs.data(), ys.data(), zs.data(), &positions[0], &positions[vector_count], &positions[2 * vector_count], &positions[3 * vector_count], vector_count );
+      } );
+
+      bool identical = (0 == memcmp( transformed.data(), reference_transformed.data(), vector_count * sizeof( Vector3 ) )) &&
+                       (0 == memcmp( normalized.data(), reference_normalized.data(), vector_count * sizeof( Vector3 ) )) &&
+                       (0 == memcmp( multiplied.data(), reference_matrices.data(), matrix_count * sizeof( Matrix4x4 ) )) &&
+                       (positions == reference_positions);
+
+      std::cout << "  " << std::left << std::setw( 12 ) << GetMathKernelSetName( kernel_set )
+                << "transform " << transform_time << " us (" << reference_transform_time / transform_time << "x), "
+                << "normalize " << normalize_time << " us (" << reference_normalize_time / normalize_time << "x), "
+                << "matrix multiply " << multiply_time << " us (" << reference_multiply_time / multiply_time << "x), "
+                << "SoA positions " << positions_time << " us (" << reference_transform_time / positions_time << "x)"
+                << (identical ? "" : " - RESULTS DIFFER") << std::endl;
+    }
+    SetMathKernelSet( previous_kernel_set );
+
+    // Streams too big for the cache of one core are where threads pay off
+    size_t const stream_size = 4 * 1024 * 1024;
+    std::vector<float> stream( 3 * stream_size );
+    for( auto & element : stream ) {
+      element = random();
+    }
+    std::vector<float> single_thread_results( 3 * stream_size );
+    std::vector<float> thread_pool_results( 3 * stream_size );
+    ThreadPool thread_pool;
+    double single_thread_time = MeasureMicroseconds( [&]() {
+      TransformPositionsSoA( transform, &stream[0], &stream[stream_size], &stream[2 * stream_size],
+                             &single_thread_results[0], &single_thread_results[stream_size], &single_thread_results[2 * stream_size], nullptr, stream_size );
+    } );
+    double thread_pool_time = MeasureMicroseconds( [&]() {
+      TransformPositionsSoA( thread_pool, transform, &stream[0], &stream[stream_size], &stream[2 * stream_size],
+                             &thread_pool_results[0], &thread_pool_results[stream_size], &thread_pool_results[2 * stream_size], nullptr, stream_size );
+    } );
+    std::cout << "  SoA positions, " << stream_size << " points: 1 thread " << single_thread_time << " us, "
+              << thread_pool.GetThreadCount() << " threads " << thread_pool_time << " us (" << single_thread_time / thread_pool_time << "x)"
+              << ((single_thread_results == thread_pool_results) ? "" : " - RESULTS DIFFER") << std::endl;
+  }
+
+} // namespace VulkanCookbook
@@ -0,0 +1,474 @@
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Memory Allocator
+
+#include <algorithm>
+#include <set>
+#include "MemoryAllocator.h"
+
+namespace VulkanCookbook {
+
+  // Single vkAllocateMemory object split with a buddy allocator.
+  // Level 0 is the whole block, every next level halves the node size.
+  struct MemoryBlock {
+    VkDeviceMemory                       Memory;
+    VkDeviceSize                         Size;
+    uint32_t                             MemoryType;
+    MemoryResourceKind                   Kind;
+    unsigned char                      * Data;
+    std::vector<std::set<VkDeviceSize>>  FreeNodes;
+    VkDeviceSize                         UsedSize;
+    uint32_t                             AllocationCount;
+  };
+
+  namespace {
+
+    VkDeviceSize RoundUpToPowerOfTwo( VkDeviceSize value ) {
+      VkDeviceSize result = 1;
+      while( result < value ) {
+        result <<= 1;
+      }
+      return result;
+    }
+
+    VkDeviceSize RoundDownToPowerOfTwo( VkDeviceSize value ) {
+      VkDeviceSize result = 1;
+      while( (result << 1) <= value ) {
+        result <<= 1;
+      }
+      return result;
+    }
+
+    uint32_t Log2( VkDeviceSize value ) {
+      uint32_t result = 0;
+      while( value > 1 ) {
+        value >>= 1;
+        ++result;
+      }
+      return result;
+    }
+
+    bool AllocateFromBlock( MemoryBlock  & block,
+                            VkDeviceSize   size,
+                            VkDeviceSize   alignment,
+                            VkDeviceSize & offset,
+                            uint32_t     & level ) {
+      // Nodes are aligned to their own size, so a node at least as big as
+      // the alignment is always suitably aligned
+      VkDeviceSize node_size = RoundUpToPowerOfTwo( std::max( { size, alignment, DeviceMemoryAllocator::MinimalNodeSize } ) );
+      if( node_size > block.Size ) {
+        return false;
+      }
+      uint32_t target_level = Log2( block.Size / node_size );
+
+      int32_t current_level = static_cast<int32_t>(target_level);
+      while( (current_level >= 0) && block.FreeNodes[current_level].empty() ) {
+        --current_level;
+      }
+      if( current_level < 0 ) {
+        return false;
+      }
+
+      offset = *block.FreeNodes[current_level].begin();
+      block.FreeNodes[current_level].erase( block.FreeNodes[current_level].begin() );
+
+      // Split the node until it matches the requested size, keeping upper halves free
+      while( static_cast<uint32_t>(current_level) < target_level ) {
+        ++current_level;
+        block.FreeNodes[current_level].insert( offset + (block.Size >> current_level) );
+      }
+
+      level = target_level;
+      block.UsedSize += node_size;
+      ++block.AllocationCount;
+      return true;
+    }
+
+    void FreeFromBlock( MemoryBlock  & block,
+                        VkDeviceSize   offset,
+                        uint32_t       level ) {
+      block.UsedSize -= block.Size >> level;
+      --block.AllocationCount;
+
+      // Merge with the buddy node for as long as it is free too
+      while( level > 0 ) {
+        VkDeviceSize buddy = offset ^ (block.Size >> level);
+        if( 0 == block.FreeNodes[level].erase( buddy ) ) {
+          break;
+        }
+        offset = std::min( offset, buddy );
+        --level;
+      }
+      block.FreeNodes[level].insert( offset );
+    }
+
+  } // namespace
+
+  DeviceMemoryAllocator::DeviceMemoryAllocator() :
+    Dispatch( nullptr ),
+    MemoryProperties( {} ),
+    NonCoherentAtomSize( 1 ),
+    BlockSize( DefaultBlockSize ),
+    DedicatedAllocationCount( 0 ),
+    AllocationCount( 0 ) {
+  }
+
+  DeviceMemoryAllocator::~DeviceMemoryAllocator() {
+    Destroy();
+  }
+
+  bool DeviceMemoryAllocator::Initialize( VkPhysicalDevice       physical_device,
+                                          DeviceDispatch const & dispatch,
+                                          VkDeviceSize           block_size ) {
+    if( (VK_NULL_HANDLE == physical_device) ||
+        (VK_NULL_HANDLE == dispatch.Device) ) {
+      std::cout << "Could not initialize memory allocator without a device." << std::endl;
+      return false;
+    }
+
+    VkPhysicalDeviceProperties device_properties;
+    vkGetPhysicalDeviceProperties( physical_device, &device_properties );
+    vkGetPhysicalDeviceMemoryProperties( physical_device, &MemoryProperties );
+
+    Dispatch = &dispatch;
+    NonCoherentAtomSize = std::max<VkDeviceSize>( device_properties.limits.nonCoherentAtomSize, 1 );
+    BlockSize = RoundDownToPowerOfTwo( std::max( block_size, MinimalNodeSize ) );
+    return true;
+  }
+
+  void DeviceMemoryAllocator::Destroy() {
+    std::lock_guard<std::mutex> lock( Mutex );
+
+    if( (AllocationCount > 0) || (DedicatedAllocationCount > 0) ) {
+      std::cout << "Destroying memory allocator with " << AllocationCount + DedicatedAllocationCount
+                << " allocations still alive." << std::endl;
+    }
+    for( auto & block : Blocks ) {
+      Dispatch->vkFreeMemory( Dispatch->Device, block->Memory, nullptr );
+    }
+    Blocks.clear();
+    AllocationCount = 0;
+    DedicatedAllocationCount = 0;
+  }
+
+  bool DeviceMemoryAllocator::Allocate( VkMemoryRequirements const & memory_requirements,
+                                        VkMemoryPropertyFlags        memory_properties,
+                                        MemoryResourceKind           kind,
+                                        MemoryAllocation           & allocation ) {
+    allocation = nullptr;
+
+    // Try every memory type compatible with the resource, so running out of
+    // a preferred heap falls back to the next suitable one
+    for( uint32_t type = 0; type < MemoryProperties.memoryTypeCount; ++type ) {
+      if( (memory_requirements.memoryTypeBits & (1 << type)) &&
+          ((MemoryProperties.memoryTypes[type].propertyFlags & memory_properties) == memory_properties) ) {
+        if( AllocateFromType( memory_requirements, type, kind, allocation ) ) {
+          return true;
+        }
+      }
+    }
+
+    std::cout << "Could not allocate " << memory_requirements.size << " bytes of device memory." << std::endl;
+    return false;
+  }
+
+  bool DeviceMemoryAllocator::AllocateFromType( VkMemoryRequirements const & memory_requirements,
+                                                uint32_t                     memory_type,
+                                                MemoryResourceKind           kind,
+                                                MemoryAllocation           & allocation ) {
+    VkMemoryPropertyFlags type_properties = MemoryProperties.memoryTypes[memory_type].propertyFlags;
+    VkDeviceSize alignment = memory_requirements.alignment;
+    if( (type_properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) &&
+        !(type_properties & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) ) {
+      // Flushed ranges must never spill over a neighbouring allocation
+      alignment = std::max( alignment, NonCoherentAtomSize );
+    }
+
+    std::lock_guard<std::mutex> lock( Mutex );
+
+    // Large resources don't benefit from sub-allocation
+    if( memory_requirements.size > BlockSize / 2 ) {
+      return AllocateDedicated( memory_requirements, memory_type, allocation );
+    }
+
+    VkDeviceSize offset;
+    uint32_t level;
+    for( auto & block : Blocks ) {
+      if( (block->MemoryType == memory_type) &&
+          (block->Kind == kind) &&
+          AllocateFromBlock( *block, memory_requirements.size, alignment, offset, level ) ) {
+        allocation = new DeviceMemoryAllocation( { block->Memory, offset, memory_requirements.size,
+                                                   block->Data ? block->Data + offset : nullptr,
+                                                   memory_type, block.get(), level } );
+        ++AllocationCount;
+        return true;
+      }
+    }
+
+    MemoryBlock * block;
+    if( !CreateBlock( memory_type, kind, BlockSize, block ) ) {
+      return false;
+    }
+    if( !AllocateFromBlock( *block, memory_requirements.size, alignment, offset, level ) ) {
+      // Alignment doesn't fit into an empty block - don't keep the block around,
+      // give the resource its own memory object instead
+      Dispatch->vkFreeMemory( Dispatch->Device, block->Memory, nullptr );
+      Blocks.pop_back();
+      return AllocateDedicated( memory_requirements, memory_type, allocation );
+    }
+    allocation = new DeviceMemoryAllocation( { block->Memory, offset, memory_requirements.size,
+                                               block->Data ? block->Data + offset : nullptr,
+                                               memory_type, block, level } );
+    ++AllocationCount;
+    return true;
+  }
+
+  bool DeviceMemoryAllocator::AllocateDedicated( VkMemoryRequirements const & memory_requirements,
+                                                 uint32_t                     memory_type,
+                                                 MemoryAllocation           & allocation ) {
+    VkDeviceMemory memory;
+    unsigned char * data;
+    if( !AllocateMemoryObject( memory_type, memory_requirements.size, memory, data ) ) {
+      return false;
+    }
+    allocation = new DeviceMemoryAllocation( { memory, 0, memory_requirements.size, data, memory_type, nullptr, 0 } );
+    ++DedicatedAllocationCount;
+    return true;
+  }
+
+  bool DeviceMemoryAllocator::AllocateMemoryObject( uint32_t          memory_type,
+                                                    VkDeviceSize      size,
+                                                    VkDeviceMemory  & memory,
+                                                    unsigned char  *& data ) {
+    VkMemoryAllocateInfo memory_allocate_info = {
+      VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,   // VkStructureType    sType
+      nullptr,                                  // const void       * pNext
+      size,                                     // VkDeviceSize       allocationSize
+      memory_type                               // uint32_t           memoryTypeIndex
+    };
+
+    memory = VK_NULL_HANDLE;
+    data = nullptr;
+    VkResult result = Dispatch->vkAllocateMemory( Dispatch->Device, &memory_allocate_info, nullptr, &memory );
+    if( (VK_SUCCESS != result) ||
+        (VK_NULL_HANDLE == memory) ) {
+      return false;
+    }
+
+    if( MemoryProperties.memoryTypes[memory_type].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT ) {
+      void * mapped_data = nullptr;
+      result = Dispatch->vkMapMemory( Dispatch->Device, memory, 0, VK_WHOLE_SIZE, 0, &mapped_data );
+      if( (VK_SUCCESS != result) ||
+          (nullptr == mapped_data) ) {
+        std::cout << "Could not map memory object." << std::endl;
+        Dispatch->vkFreeMemory( Dispatch->Device, memory, nullptr );
+        memory = VK_NULL_HANDLE;
+        return false;
+      }
+      data = static_cast<unsigned char *>(mapped_data);
+    }
+    return true;
+  }
+
+  bool DeviceMemoryAllocator::CreateBlock( uint32_t             memory_type,
+                                           MemoryResourceKind   kind,
+                                           VkDeviceSize         size,
+                                           MemoryBlock       *& block ) {
+    VkDeviceMemory memory;
+    unsigned char * data;
+    if( !AllocateMemoryObject( memory_type, size, memory, data ) ) {
+      return false;
+    }
+
+    std::unique_ptr<MemoryBlock> new_block( new MemoryBlock );
+    new_block->Memory = memory;
+    new_block->Size = size;
+    new_block->MemoryType = memory_type;
+    new_block->Kind = kind;
+    new_block->Data = data;
+    new_block->FreeNodes.resize( Log2( size / MinimalNodeSize ) + 1 );
+    new_block->FreeNodes[0].insert( 0 );
+    new_block->UsedSize = 0;
+    new_block->AllocationCount = 0;
+
+    block = new_block.get();
+    Blocks.push_back( std::move( new_block ) );
+    return true;
+  }
+
+  void DeviceMemoryAllocator::ReleaseBlock( MemoryBlock * block ) {
+    // Keep one empty block per memory type and resource kind around, so
+    // a resource recreated every frame doesn't hit vkAllocateMemory each time
+    bool has_spare_block = false;
+    for( auto & other : Blocks ) {
+      if( (other.get() != block) &&
+          (other->MemoryType == block->MemoryType) &&
+          (other->Kind == block->Kind) &&
+          (other->AllocationCount == 0) ) {
+        has_spare_block = true;
+        break;
+      }
+    }
+    if( !has_spare_block ) {
+      return;
+    }
+
+    auto it = std::find_if( Blocks.begin(), Blocks.end(), [block]( std::unique_ptr<MemoryBlock> const & other ) {
+      return other.get() == block;
+    } );
+    if( it != Blocks.end() ) {
+      Dispatch->vkFreeMemory( Dispatch->Device, block->Memory, nullptr );
+      Blocks.erase( it );
+    }
+  }
+
+  void DeviceMemoryAllocator::Free( MemoryAllocation allocation ) {
+    if( nullptr == allocation ) {
+      return;
+    }
+
+    std::lock_guard<std::mutex> lock( Mutex );
+
+    if( nullptr == allocation->Block ) {
+      Dispatch->vkFreeMemory( Dispatch->Device, allocation->Memory, nullptr );
+      --DedicatedAllocationCount;
+    } else {
+      MemoryBlock * block = allocation->Block;
+      FreeFromBlock( *block, allocation->Offset, allocation->Level );
+      --AllocationCount;
+      if( 0 == block->AllocationCount ) {
+        ReleaseBlock( block );
+      }
+    }
+    delete allocation;
+  }
+
+  bool DeviceMemoryAllocator::SyncMappedRange( MemoryAllocation allocation,
+                                               VkDeviceSize     offset,
+                                               VkDeviceSize     size,
+                                               bool             flush ) {
+    if( (nullptr == allocation) ||
+        (nullptr == allocation->Data) ) {
+      return false;
+    }
+    if( MemoryProperties.memoryTypes[allocation->MemoryType].propertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT ) {
+      return true;
+    }
+
+    if( VK_WHOLE_SIZE == size ) {
+      size = allocation->Size - offset;
+    }
+    VkDeviceSize begin = ((allocation->Offset + offset) / NonCoherentAtomSize) * NonCoherentAtomSize;
+    VkDeviceSize end = ((allocation->Offset + offset + size + NonCoherentAtomSize - 1) / NonCoherentAtomSize) * NonCoherentAtomSize;
+    VkDeviceSize memory_size = allocation->Block ? allocation->Block->Size : allocation->Size;
+
+    VkMappedMemoryRange memory_range = {
+      VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE,                    // VkStructureType    sType
+      nullptr,                                                  // const void       * pNext
+      allocation->Memory,                                       // VkDeviceMemory     memory
+      begin,                                                    // VkDeviceSize       offset
+      (end >= memory_size) ? VK_WHOLE_SIZE : (end - begin)      // VkDeviceSize       size
+    };
+
+    VkResult result = flush
+      ? Dispatch->vkFlushMappedMemoryRanges( Dispatch->Device, 1, &memory_range )
+      : Dispatch->vkInvalidateMappedMemoryRanges( Dispatch->Device, 1, &memory_range );
+    if( VK_SUCCESS != result ) {
+      std::cout << "Could not " << (flush ? "flush" : "invalidate") << " mapped memory range." << std::endl;
+      return false;
+    }
+    return true;
+  }
+
+  bool DeviceMemoryAllocator::FlushMappedRange( MemoryAllocation allocation,
+                                                VkDeviceSize     offset,
+                                                VkDeviceSize     size ) {
+    return SyncMappedRange( allocation, offset, size, true );
+  }
+
+  bool DeviceMemoryAllocator::InvalidateMappedRange( MemoryAllocation allocation,
+                                                     VkDeviceSize     offset,
+                                                     VkDeviceSize     size ) {
+    return SyncMappedRange( allocation, offset, size, false );
+  }
+
+  MemoryAllocatorStatistics DeviceMemoryAllocator::GetStatistics() {
+    std::lock_guard<std::mutex> lock( Mutex );
+
+    MemoryAllocatorStatistics statistics = {
+      static_cast<uint32_t>(Blocks.size()) + DedicatedAllocationCount,
+      AllocationCount + DedicatedAllocationCount,
+      0,
+      0
+    };
+    for( auto & block : Blocks ) {
+      statistics.ReservedBytes += block->Size;
+      statistics.UsedBytes += block->UsedSize;
+    }
+    return statistics;
+  }
+
+  bool AllocateAndBindMemoryObjectToBuffer( DeviceMemoryAllocator           & allocator,
+                                            VkBuffer                          buffer,
+                                            VkMemoryPropertyFlags             memory_properties,
+                                            VkDestroyer( MemoryAllocation ) & allocation ) {
+    DeviceDispatch const & dispatch = allocator.GetDispatch();
+    VkMemoryRequirements memory_requirements;
+    dispatch.vkGetBufferMemoryRequirements( dispatch.Device, buffer, &memory_requirements );
+
+    InitVkDestroyer( allocator, allocation );
+    if( !allocator.Allocate( memory_requirements, memory_properties, MemoryResourceKind::Linear, *allocation ) ) {
+      return false;
+    }
+
+    VkResult result = dispatch.vkBindBufferMemory( dispatch.Device, buffer, (*allocation)->Memory, (*allocation)->Offset );
+    if( VK_SUCCESS != result ) {
+      std::cout << "Could not bind memory object to a buffer." << std::endl;
+      return false;
+    }
+    return true;
+  }
+
+  bool AllocateAndBindMemoryObjectToImage( DeviceMemoryAllocator           & allocator,
+                                           VkImage                           image,
+                                           VkMemoryPropertyFlags             memory_properties,
+                                           VkImageTiling                     tiling,
+                                           VkDestroyer( MemoryAllocation ) & allocation ) {
+    DeviceDispatch const & dispatch = allocator.GetDispatch();
+    VkMemoryRequirements memory_requirements;
+    dispatch.vkGetImageMemoryRequirements( dispatch.Device, image, &memory_requirements );
+
+    MemoryResourceKind kind = (VK_IMAGE_TILING_LINEAR == tiling) ? MemoryResourceKind::Linear : MemoryResourceKind::Optimal;
+
+    InitVkDestroyer( allocator, allocation );
+    if( !allocator.Allocate( memory_requirements, memory_properties, kind, *allocation ) ) {
+      return false;
+    }
+
+    VkResult result = dispatch.vkBindImageMemory( dispatch.Device, image, (*allocation)->Memory, (*allocation)->Offset );
+    if( VK_SUCCESS != result ) {
+      std::cout << "Could not bind memory object to an image." << std::endl;
+      return false;
+    }
+    return true;
+  }
+
+} // namespace VulkanCookbook
@@ -0,0 +1,484 @@
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Mesh Cache
+
+#include "MeshCache.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sys/stat.h>
+
+namespace VulkanCookbook {
+
+  struct MeshCacheHeader {
+    uint32_t    Magic;
+    uint32_t    Version;
+    uint64_t    SourceSize;
+    int64_t     SourceModificationTime;
+    uint32_t    VertexCount;
+    uint32_t    IndexCount;
+    uint32_t    IndexSize;
+    uint32_t    Flags;
+    uint64_t    VertexDataOffset;
+    uint64_t    IndexDataOffset;
+    uint64_t    DataEnd;
+  };
+
+  namespace {
+
+    uint32_t const MeshCacheMagic = 0x434D4B56;   // "VKMC"
+    uint32_t const MeshCacheVersion = 1;
+    uint32_t const MeshCacheHasNormals = 0x1;
+    uint32_t const MeshCacheHasTexcoords = 0x2;
+    uint64_t const MeshCacheAlignment = 16;
+
+    // Forsyth, "Linear-Speed Vertex Cache Optimisation"
+    uint32_t const VertexCacheSize = 32;
+    float const CacheDecayPower = 1.5f;
+    float const LastTriangleScore = 0.75f;
+    float const ValenceBoostScale = 2.0f;
+    float const ValenceBoostPower = 0.5f;
+
+    uint64_t AlignOffset( uint64_t offset ) {
+      return (offset + MeshCacheAlignment - 1) & ~(MeshCacheAlignment - 1);
+    }
+
+    bool GetFileStatus( std::string const & filename,
+                        uint64_t          & size,
+                        int64_t           & modification_time ) {
+      struct stat file_status;
+      if( 0 != stat( filename.c_str(), &file_status ) ) {
+        return false;
+      }
+      size = static_cast<uint64_t>(file_status.st_size);
+      modification_time = static_cast<int64_t>(file_status.st_mtime);
+      return true;
+    }
+
+    // Rounds to nearest; values out of range become infinity
+    uint16_t FloatToHalf( float value ) {
+      uint32_t bits;
+      memcpy( &bits, &value, sizeof( bits ) );
+      uint32_t sign = (bits >> 16) & 0x8000;
+      int32_t exponent = static_cast<int32_t>((bits >> 23) & 0xFF) - 127 + 15;
+      uint32_t mantissa = bits & 0x7FFFFF;
+
+      if( (bits & 0x7FFFFFFF) >= 0x7F800000 ) {
+        return static_cast<uint16_t>(sign | 0x7C00 | ((0 != mantissa) ? 0x200 : 0));
+      }
+      if( exponent >= 31 ) {
+        return static_cast<uint16_t>(sign | 0x7C00);
+      }
+      if( exponent <= 0 ) {
+        if( exponent < -10 ) {
+          return static_cast<uint16_t>(sign);
+        }
+        mantissa |= 0x800000;
+        uint32_t shift = static_cast<uint32_t>(14 - exponent);
+        uint32_t half = mantissa >> shift;
+        half += (mantissa >> (shift - 1)) & 1;
+        return static_cast<uint16_t>(sign | half);
+      }
+      // A carry out of the mantissa correctly bumps the exponent
+      uint32_t half = sign | (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13);
+      half += (mantissa >> 12) & 1;
+      return static_cast<uint16_t>(half);
+    }
+
+    int16_t QuantizeSnorm( float value ) {
+      return static_cast<int16_t>(std::round( std::max( -1.0f, std::min( 1.0f, value ) ) * 32767.0f ));
+    }
+
+    PackedVertex PackVertex( float const * vertex ) {
+      PackedVertex packed = {
+        { vertex[0], vertex[1], vertex[2] },
+        { QuantizeSnorm( vertex[3] ), QuantizeSnorm( vertex[4] ), QuantizeSnorm( vertex[5] ), 0 },
+        { FloatToHalf( vertex[6] ), FloatToHalf( vertex[7] ) }
+      };
+      return packed;
+    }
+
+    uint32_t HashVertex( PackedVertex const & vertex ) {
+      uint32_t words[sizeof( PackedVertex ) / sizeof( uint32_t )];
+      memcpy( words, &vertex, sizeof( words ) );
+      uint32_t hash = 2166136261u;
+      for( auto word : words ) {
+        hash = (hash ^ word) * 16777619u;
+        hash ^= hash >> 15;
+      }
+      return hash;
+    }
+
+    // Vertices equal after quantization are merged; remap receives the new index of each input vertex
+    void DeduplicateVertices( std::vector<PackedVertex> & vertices,
+                              std::vector<uint32_t>     & remap ) {
+      size_t table_size = 1;
+      while( table_size < 2 * vertices.size() ) {
+        table_size *= 2;
+      }
+      std::vector<uint32_t> table( table_size, UINT32_MAX );
+
+      remap.resize( vertices.size() );
+      uint32_t unique_count = 0;
+      for( size_t index = 0; index < vertices.size(); ++index ) {
+        size_t slot = HashVertex( vertices[index] ) & (table_size - 1);
+        while( (UINT32_MAX != table[slot]) &&
+               (0 != memcmp( &vertices[table[slot]], &vertices[index], sizeof( PackedVertex ) )) ) {
+          slot = (slot + 1) & (table_size - 1);
+        }
+        if( UINT32_MAX == table[slot] ) {
+          table[slot] = unique_count;
+          vertices[unique_count++] = vertices[index];
+        }
+        remap[index] = table[slot];
+      }
+      vertices.resize( unique_count );
+    }
+
+    float GetVertexScore( int32_t  cache_position,
+                          uint32_t remaining_triangles ) {
+      if( 0 == remaining_triangles ) {
+        return -1.0f;
+      }
+      float score = 0.0f;
+      if( cache_position >= 0 ) {
+        if( cache_position < 3 ) {
+          // The vertices of the last triangle are penalized so strips do not flip back and forth
+          score = LastTriangleScore;
+        } else {
+          score = std::pow( 1.0f - (cache_position - 3) / static_cast<float>(VertexCacheSize - 3), CacheDecayPower );
+        }
+      }
+      // Vertices with few triangles left are finished first
+      return score + ValenceBoostScale * std::pow( static_cast<float>(remaining_triangles), -ValenceBoostPower );
+    }
+
+    void OptimizeVertexCache( std::vector<uint32_t> & indices,
+                              uint32_t                vertex_count ) {
+      uint32_t triangle_count = static_cast<uint32_t>(indices.size() / 3);
+      if( 0 == triangle_count ) {
+        return;
+      }
+
+      // Triangles of every vertex; the first remaining_triangles entries are not emitted yet
+      std::vector<uint32_t> remaining_triangles( vertex_count, 0 );
+      for( auto index : indices ) {
+        ++remaining_triangles[index];
+      }
+      std::vector<uint32_t> adjacency_offsets( vertex_count + 1, 0 );
+      for( uint32_t vertex = 0; vertex < vertex_count; ++vertex ) {
+        adjacency_offsets[vertex + 1] = adjacency_offsets[vertex] + remaining_triangles[vertex];
+      }
+      std::vector<uint32_t> adjacency( indices.size() );
+      {
+        std::vector<uint32_t> cursors( adjacency_offsets.begin(), adjacency_offsets.end() - 1 );
+        for( size_t corner = 0; corner < indices.size(); ++corner ) {
+          adjacency[cursors[indices[corner]]++] = static_cast<uint32_t>(corner / 3);
+        }
+      }
+
+      std::vector<int32_t> cache_positions( vertex_count, -1 );
+      std::vector<float> vertex_scores( vertex_count );
+      for( uint32_t vertex = 0; vertex < vertex_count; ++vertex ) {
+        vertex_scores[vertex] = GetVertexScore( -1, remaining_triangles[vertex] );
+      }
+      std::vector<float> triangle_scores( triangle_count );
+      std::vector<bool> emitted( triangle_count, false );
+      uint32_t best_triangle = 0;
+      for( uint32_t triangle = 0; triangle < triangle_count; ++triangle ) {
+        triangle_scores[triangle] = vertex_scores[indices[3 * triangle]] + vertex_scores[indices[3 * triangle + 1]] + vertex_scores[indices[3 * triangle + 2]];
+        if( triangle_scores[triangle] > triangle_scores[best_triangle] ) {
+          best_triangle = triangle;
+        }
+      }
+
+      std::vector<uint32_t> optimized_indices;
+      optimized_indices.reserve( indices.size() );
+      std::vector<uint32_t> cache;
+      std::vector<uint32_t> new_cache;
+      cache.reserve( VertexCacheSize + 3 );
+      new_cache.reserve( VertexCacheSize + 3 );
+      uint32_t scan_cursor = 0;
+
+      for( uint32_t emitted_count = 0; emitted_count < triangle_count; ++emitted_count ) {
+        if( UINT32_MAX == best_triangle ) {
+          // Nothing in the cache has triangles left - continue with the next unused triangle
+          while( emitted[scan_cursor] ) {
+            ++scan_cursor;
+          }
+          best_triangle = scan_cursor;
+        }
+        emitted[best_triangle] = true;
+
+        uint32_t const * triangle_vertices = &indices[3 * best_triangle];
+        new_cache.clear();
+        for( uint32_t corner = 0; corner < 3; ++corner ) {
+          uint32_t vertex = triangle_vertices[corner];
+          optimized_indices.push_back( vertex );
+
+          uint32_t * triangles = &adjacency[adjacency_offsets[vertex]];
+          uint32_t & remaining = remaining_triangles[vertex];
+          auto position = std::find( triangles, triangles + remaining, best_triangle );
+          std::swap( *position, triangles[remaining - 1] );
+          --remaining;
+
+          if( std::find( new_cache.begin(), new_cache.end(), vertex ) == new_cache.end() ) {
+            new_cache.push_back( vertex );
+          }
+        }
+        for( auto vertex : cache ) {
+          if( std::find( new_cache.begin(), new_cache.end(), vertex ) == new_cache.end() ) {
+            new_cache.push_back( vertex );
+          }
+        }
+
+        // Vertices pushed out of the cache get their scores updated as well
+        for( size_t position = 0; position < new_cache.size(); ++position ) {
+          uint32_t vertex = new_cache[position];
+          cache_positions[vertex] = (position < VertexCacheSize) ? static_cast<int32_t>(position) : -1;
+          float score = GetVertexScore( cache_positions[vertex], remaining_triangles[vertex] );
+          float delta = score - vertex_scores[vertex];
+          vertex_scores[vertex] = score;
+          uint32_t const * triangles = &adjacency[adjacency_offsets[vertex]];
+          for( uint32_t triangle = 0; triangle < remaining_triangles[vertex]; ++triangle ) {
+            triangle_scores[triangles[triangle]] += delta;
+          }
+        }
+        if( new_cache.size() > VertexCacheSize ) {
+          new_cache.resize( VertexCacheSize );
+        }
+        cache.swap( new_cache );
+
+        best_triangle = UINT32_MAX;
+        float best_score = -1.0f;
+        for( auto vertex : cache ) {
+          uint32_t const * triangles = &adjacency[adjacency_offsets[vertex]];
+          for( uint32_t triangle = 0; triangle < remaining_triangles[vertex]; ++triangle ) {
+            if( triangle_scores[triangles[triangle]] > best_score ) {
+              best_score = triangle_scores[triangles[triangle]];
+              best_triangle = triangles[triangle];
+            }
+          }
+        }
+      }
+      indices.swap( optimized_indices );
+    }
+
+    // Renumbers vertices in the order of their first use and drops unused ones
+    void OptimizeVertexFetch( std::vector<PackedVertex> & vertices,
+                              std::vector<uint32_t>     & indices ) {
+      std::vector<uint32_t> remap( vertices.size(), UINT32_MAX );
+      std::vector<PackedVertex> ordered_vertices;
+      ordered_vertices.reserve( vertices.size() );
+      for( auto & index : indices ) {
+        if( UINT32_MAX == remap[index] ) {
+          remap[index] = static_cast<uint32_t>(ordered_vertices.size());
+          ordered_vertices.push_back( vertices[index] );
+        }
+        index = remap[index];
+      }
+      vertices.swap( ordered_vertices );
+    }
+
+  } // namespace
+
+  void OptimizeMesh( InterleavedMesh const & mesh,
+                     OptimizedMesh         & optimized_mesh ) {
+    size_t vertex_count = mesh.Vertices.size() / InterleavedMesh::VertexStride;
+    optimized_mesh.HasNormals = mesh.HasNormals;
+    optimized_mesh.HasTexcoords = mesh.HasTexcoords;
+
+    optimized_mesh.Vertices.resize( vertex_count );
+    for( size_t vertex = 0; vertex < vertex_count; ++vertex ) {
+      optimized_mesh.Vertices[vertex] = PackVertex( &mesh.Vertices[InterleavedMesh::VertexStride * vertex] );
+    }
+
+    std::vector<uint32_t> remap;
+    DeduplicateVertices( optimized_mesh.Vertices, remap );
+
+    optimized_mesh.Indices.resize( mesh.Indices.size() );
+    for( size_t index = 0; index < mesh.Indices.size(); ++index ) {
+      optimized_mesh.Indices[index] = remap[mesh.Indices[index]];
+    }
+
+    OptimizeVertexCache( optimized_mesh.Indices, static_cast<uint32_t>(optimized_mesh.Vertices.size()) );
+    OptimizeVertexFetch( optimized_mesh.Vertices, optimized_mesh.Indices );
+  }
+
+  bool SaveMeshCache( std::string const   & filename,
+                      OptimizedMesh const & mesh,
+                      uint64_t              source_size,
+                      int64_t               source_modification_time ) {
+    bool short_indices = mesh.Vertices.size() <= 65536;
+
+    MeshCacheHeader header = {};
+    header.Magic = MeshCacheMagic;
+    header.Version = MeshCacheVersion;
+    header.SourceSize = source_size;
+    header.SourceModificationTime = source_modification_time;
+    header.VertexCount = static_cast<uint32_t>(mesh.Vertices.size());
+    header.IndexCount = static_cast<uint32_t>(mesh.Indices.size());
+    header.IndexSize = short_indices ? sizeof( uint16_t ) : sizeof( uint32_t );
+    header.Flags = (mesh.HasNormals ? MeshCacheHasNormals : 0) | (mesh.HasTexcoords ? MeshCacheHasTexcoords : 0);
+    header.VertexDataOffset = AlignOffset( sizeof( MeshCacheHeader ) );
+    header.IndexDataOffset = AlignOffset( header.VertexDataOffset + mesh.Vertices.size() * sizeof( PackedVertex ) );
+    header.DataEnd = header.IndexDataOffset + static_cast<uint64_t>(header.IndexCount) * header.IndexSize;
+
+    // Written under a temporary name, so an interrupted conversion never leaves a valid looking cache
+    std::string temporary_filename = GetTemporaryFilename( filename );
+    std::ofstream file( temporary_filename, std::ios::binary | std::ios::trunc );
+    if( file.fail() ) {
+      std::cout << "Could not create '" << temporary_filename << "' file." << std::endl;
+      return false;
+    }
+
+    char const padding[MeshCacheAlignment] = {};
+    file.write( reinterpret_cast<char const *>(&header), sizeof( header ) );
+    file.write( padding, header.VertexDataOffset - sizeof( header ) );
+    file.write( reinterpret_cast<char const *>(mesh.Vertices.data()), mesh.Vertices.size() * sizeof( PackedVertex ) );
+    file.write( padding, header.IndexDataOffset - header.VertexDataOffset - mesh.Vertices.size() * sizeof( PackedVertex ) );
+    if( short_indices ) {
+      std::vector<uint16_t> short_index_data( mesh.Indices.begin(), mesh.Indices.end() );
+      file.write( reinterpret_cast<char const *>(short_index_data.data()), short_index_data.size() * sizeof( uint16_t ) );
+    } else {
+      file.write( reinterpret_cast<char const *>(mesh.Indices.data()), mesh.Indices.size() * sizeof( uint32_t ) );
+    }
+    file.close();
+    if( file.fail() ) {
+      std::cout << "Could not write '" << temporary_filename << "' file." << std::endl;
+      std::remove( temporary_filename.c_str() );
+      return false;
+    }
+
+    return ReplaceFileAtomically( temporary_filename, filename );
+  }
+
+  CachedMesh::CachedMesh() :
+    Header( nullptr ) {
+  }
+
+  bool CachedMesh::Open( std::string const & filename,
+                         uint64_t            source_size,
+                         int64_t             source_modification_time ) {
+    Close();
+
+    // A missing cache is not an error
+    uint64_t size;
+    int64_t modification_time;
+    if( !GetFileStatus( filename, size, modification_time ) ||
+        (size < sizeof( MeshCacheHeader )) ) {
+      return false;
+    }
+    // Everything is going to be uploaded, so read it all right away
+    if( !File.Open( filename, MAPPED_FILE_HINT_SEQUENTIAL_BIT | MAPPED_FILE_HINT_POPULATE_BIT ) ) {
+      return false;
+    }
+
+    MeshCacheHeader const * header = reinterpret_cast<MeshCacheHeader const *>(File.GetData());
+    if( (MeshCacheMagic != header->Magic) ||
+        (MeshCacheVersion != header->Version) ||
+        (source_size != header->SourceSize) ||
+        (source_modification_time != header->SourceModificationTime) ) {
+      Close();
+      return false;
+    }
+    if( ((sizeof( uint16_t ) != header->IndexSize) && (sizeof( uint32_t ) != header->IndexSize)) ||
+        (header->VertexDataOffset < sizeof( MeshCacheHeader )) ||
+        (header->IndexDataOffset < header->VertexDataOffset + static_cast<uint64_t>(header->VertexCount) * sizeof( PackedVertex )) ||
+        (header->DataEnd != header->IndexDataOffset + static_cast<uint64_t>(header->IndexCount) * header->IndexSize) ||
+        (header->DataEnd > File.GetSize()) ) {
+      std::cout << "The '" << filename << "' mesh cache is damaged." << std::endl;
+      Close();
+      return false;
+    }
+    Header = header;
+    return true;
+  }
+
+  void CachedMesh::Close() {
+    Header = nullptr;
+    File.Close();
+  }
+
+  uint32_t CachedMesh::GetVertexCount() const {
+    return (nullptr != Header) ? Header->VertexCount : 0;
+  }
+
+  uint32_t CachedMesh::GetIndexCount() const {
+    return (nullptr != Header) ? Header->IndexCount : 0;
+  }
+
+  VkIndexType CachedMesh::GetIndexType() const {
+    return ((nullptr != Header) && (sizeof( uint16_t ) == Header->IndexSize)) ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+  }
+
+  bool CachedMesh::HasNormals() const {
+    return (nullptr != Header) && (0 != (Header->Flags & MeshCacheHasNormals));
+  }
+
+  bool CachedMesh::HasTexcoords() const {
+    return (nullptr != Header) && (0 != (Header->Flags & MeshCacheHasTexcoords));
+  }
+
+  void const * CachedMesh::GetData() const {
+    return (nullptr != Header) ? File.GetData() + Header->VertexDataOffset : nullptr;
+  }
+
+  VkDeviceSize CachedMesh::GetDataSize() const {
+    return (nullptr != Header) ? Header->DataEnd - Header->VertexDataOffset : 0;
+  }
+
+  VkDeviceSize CachedMesh::GetIndexDataOffset() const {
+    return (nullptr != Header) ? Header->IndexDataOffset - Header->VertexDataOffset : 0;
+  }
+
+  bool LoadMeshWithCache( std::string const & obj_filename,
+                          ThreadPool        & thread_pool,
+                          CachedMesh        & mesh ) {
+    uint64_t source_size;
+    int64_t source_modification_time;
+    if( !GetFileStatus( obj_filename, source_size, source_modification_time ) ) {
+      std::cout << "Could not open '" << obj_filename << "' file." << std::endl;
+      return false;
+    }
+
+    std::string cache_filename = obj_filename + ".meshcache";
+    if( mesh.Open( cache_filename, source_size, source_modification_time ) ) {
+      return true;
+    }
+
+    {
+      OptimizedMesh optimized_mesh;
+      {
+        InterleavedMesh interleaved_mesh;
+        if( !LoadInterleavedMeshFromObjFile( obj_filename, thread_pool, interleaved_mesh ) ) {
+          return false;
+        }
+        OptimizeMesh( interleaved_mesh, optimized_mesh );
+      }
+      if( !SaveMeshCache( cache_filename, optimized_mesh, source_size, source_modification_time ) ) {
+        return false;
+      }
+    }
+    return mesh.Open( cache_filename, source_size, source_modification_time );
+  }
+
+} // namespace VulkanCookbook
@@ -0,0 +1,541 @@
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Mesh Loader
+
+#include "MeshLoader.h"
+#include "Tools.h"
+#include <algorithm>
+
+namespace VulkanCookbook {
+
+  namespace {
+
+    size_t const MinimalChunkSize = 1024 * 1024;
+
+    struct ObjChunk {
+      char const  * Begin;
+      char const  * End;
+      uint64_t      PositionCount;
+      uint64_t      NormalCount;
+      uint64_t      TexcoordCount;
+      uint64_t      TriangleCount;
+      uint64_t      PositionBase;
+      uint64_t      NormalBase;
+      uint64_t      TexcoordBase;
+      uint64_t      TriangleBase;
+      bool          SharedIndices;
+      bool          Valid;
+    };
+
+    struct ObjCorner {
+      int64_t   Position;
+      int64_t   Texcoord;     // 0 when omitted
+      int64_t   Normal;       // 0 when omitted
+    };
+
+    enum class ObjLineType {
+      Position,
+      Texcoord,
+      Normal,
+      Face,
+      Other
+    };
+
+    bool IsSpace( char character ) {
+      return (' ' == character) || ('\t' == character);
+    }
+
+    bool IsLineEnd( char character ) {
+      return ('\n' == character) || ('\r' == character) || ('#' == character);
+    }
+
+    void SkipSpaces( char const *& cursor,
+                     char const  * end ) {
+      while( (cursor < end) && IsSpace( *cursor ) ) {
+        ++cursor;
+      }
+    }
+
+    void SkipLine( char const *& cursor,
+                   char const  * end ) {
+      void const * line_end = memchr( cursor, '\n', end - cursor );
+      cursor = (nullptr != line_end) ? static_cast<char const *>(line_end) + 1 : end;
+    }
+
+    ObjLineType ReadLineType( char const *& cursor,
+                              char const  * end ) {
+      SkipSpaces( cursor, end );
+      if( end - cursor < 2 ) {
+        return ObjLineType::Other;
+      }
+      if( 'f' == cursor[0] ) {
+        if( IsSpace( cursor[1] ) ) {
+          cursor += 1;
+          return ObjLineType::Face;
+        }
+      } else if( 'v' == cursor[0] ) {
+        if( IsSpace( cursor[1] ) ) {
+          cursor += 1;
+          return ObjLineType::Position;
+        }
+        if( (end - cursor > 2) && IsSpace( cursor[2] ) ) {
+          if( 't' == cursor[1] ) {
+            cursor += 2;
+            return ObjLineType::Texcoord;
+          }
+          if( 'n' == cursor[1] ) {
+            cursor += 2;
+            return ObjLineType::Normal;
+          }
+        }
+      }
+      return ObjLineType::Other;
+    }
+
+    // Locale independent and much faster than strtof; exact enough for mesh data
+    bool ParseFloat( char const *& cursor,
+                     char const  * end,
+                     float       & value ) {
+      static double const powers_of_ten[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+        1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18
+      };
+
+      SkipSpaces( cursor, end );
+      bool negative = false;
+      if( (cursor < end) && (('-' == *cursor) || ('+' == *cursor)) ) {
+        negative = ('-' == *cursor);
+        ++cursor;
+      }
+
+      uint64_t mantissa = 0;
+      int exponent = 0;
+      int digit_count = 0;
+      int significant_digit_count = 0;
+      for( ; (cursor < end) && (*cursor >= '0') && (*cursor <= '9'); ++cursor, ++digit_count ) {
+        if( significant_digit_count < 18 ) {
+          mantissa = 10 * mantissa + (*cursor - '0');
+          significant_digit_count += (mantissa > 0) ? 1 : 0;
+        } else {
+          ++exponent;
+        }
+      }
+      if( (cursor < end) && ('.' == *cursor) ) {
+        for( ++cursor; (cursor < end) && (*cursor >= '0') && (*cursor <= '9'); ++cursor, ++digit_count ) {
+          if( significant_digit_count < 18 ) {
+            mantissa = 10 * mantissa + (*cursor - '0');
+            significant_digit_count += (mantissa > 0) ? 1 : 0;
+            --exponent;
+          }
+        }
+      }
+      if( 0 == digit_count ) {
+        return false;
+      }
+      if( (cursor < end) && (('e' == *cursor) || ('E' == *cursor)) ) {
+        ++cursor;
+        bool negative_exponent = false;
+        if( (cursor < end) && (('-' == *cursor) || ('+' == *cursor)) ) {
+          negative_exponent = ('-' == *cursor);
+          ++cursor;
+        }
+        int explicit_exponent = 0;
+        for( ; (cursor < end) && (*cursor >= '0') && (*cursor <= '9'); ++cursor ) {
+          explicit_exponent = std::min( 10 * explicit_exponent + (*cursor - '0'), 1000 );
+        }
+        exponent += negative_exponent ? -explicit_exponent : explicit_exponent;
+      }
+
+      double result = static_cast<double>(mantissa);
+      while( exponent < 0 ) {
+        int step = std::min( -exponent, 18 );
+        result /= powers_of_ten[step];
+        exponent += step;
+      }
+      while( exponent > 0 ) {
+        int step = std::min( exponent, 18 );
+        result *= powers_of_ten[step];
+        exponent -= step;
+      }
+      value = static_cast<float>(negative ? -result : result);
+      return true;
+    }
+
+    bool ParseInteger( char const *& cursor,
+                       char const  * end,
+                       int64_t     & value ) {
+      bool negative = false;
+      if( (cursor < end) && ('-' == *cursor) ) {
+        negative = true;
+        ++cursor;
+      }
+      if( (cursor >= end) || (*cursor < '0') || (*cursor > '9') ) {
+        return false;
+      }
+      value = 0;
+      for( ; (cursor < end) && (*cursor >= '0') && (*cursor <= '9'); ++cursor ) {
+        value = 10 * value + (*cursor - '0');
+      }
+      if( negative ) {
+        value = -value;
+      }
+      return true;
+    }
+
+    // Reads "v", "v/vt", "v//vn" or "v/vt/vn" corners until the end of the line
+    bool ParseFace( char const             *& cursor,
+                    char const              * end,
+                    std::vector<ObjCorner>  & corners ) {
+      corners.clear();
+      while( true ) {
+        SkipSpaces( cursor, end );
+        if( (cursor >= end) || IsLineEnd( *cursor ) ) {
+          return true;
+        }
+
+        ObjCorner corner = { 0, 0, 0 };
+        if( !ParseInteger( cursor, end, corner.Position ) ) {
+          return false;
+        }
+        if( (cursor < end) && ('/' == *cursor) ) {
+          ++cursor;
+          if( (cursor < end) && ('/' != *cursor) &&
+              !ParseInteger( cursor, end, corner.Texcoord ) ) {
+            return false;
+          }
+          if( (cursor < end) && ('/' == *cursor) ) {
+            ++cursor;
+            if( !ParseInteger( cursor, end, corner.Normal ) ) {
+              return false;
+            }
+          }
+        }
+        if( (cursor < end) && !IsSpace( *cursor ) && !IsLineEnd( *cursor ) ) {
+          return false;
+        }
+        corners.push_back( corner );
+      }
+    }
+
+    // Converts a one-based or negative (relative) index into a zero-based one
+    bool ResolveIndex( int64_t    index,
+                       uint64_t   count_before,
+                       uint64_t   total_count,
+                       uint64_t & resolved ) {
+      if( index > 0 ) {
+        resolved = static_cast<uint64_t>(index - 1);
+      } else if( (index < 0) &&
+                 (static_cast<uint64_t>(-index) <= count_before) ) {
+        resolved = count_before - static_cast<uint64_t>(-index);
+      } else {
+        return false;
+      }
+      return resolved < total_count;
+    }
+
+    // Pass one - counts elements and checks whether vertices can follow the "v" lines
+    void CountChunk( ObjChunk & chunk ) {
+      std::vector<ObjCorner> corners;
+      char const * cursor = chunk.Begin;
+      while( cursor < chunk.End ) {
+        switch( ReadLineType( cursor, chunk.End ) ) {
+        case ObjLineType::Position:
+          ++chunk.PositionCount;
+          break;
+        case ObjLineType::Texcoord:
+          ++chunk.TexcoordCount;
+          break;
+        case ObjLineType::Normal:
+          ++chunk.NormalCount;
+          break;
+        case ObjLineType::Face:
+          if( !ParseFace( cursor, chunk.End, corners ) ) {
+            chunk.Valid = false;
+            return;
+          }
+          if( corners.size() >= 3 ) {
+            chunk.TriangleCount += corners.size() - 2;
+          }
+          for( auto & corner : corners ) {
+            if( (corner.Position < 0) ||
+                ((0 != corner.Texcoord) && (corner.Texcoord != corner.Position)) ||
+                ((0 != corner.Normal) && (corner.Normal != corner.Position)) ) {
+              chunk.SharedIndices = false;
+            }
+          }
+          break;
+        case ObjLineType::Other:
+          break;
+        }
+        SkipLine( cursor, chunk.End );
+      }
+    }
+
+    bool ParseAttribute( char const *& cursor,
+                         char const  * end,
+                         float       * destination,
+                         uint32_t      component_count ) {
+      for( uint32_t component = 0; component < component_count; ++component ) {
+        if( !ParseFloat( cursor, end, destination[component] ) ) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    // Strides are in floats
+    struct ObjAttributes {
+      float     * Positions;
+      uint32_t    PositionStride;
+      float     * Normals;
+      uint32_t    NormalStride;
+      float     * Texcoords;
+      uint32_t    TexcoordStride;
+    };
+
+    struct ObjTotals {
+      uint64_t    PositionCount;
+      uint64_t    NormalCount;
+      uint64_t    TexcoordCount;
+    };
+
+    // Pass two - stores attributes and, when faces is not null, triangles.
+    // In the shared layout both happen at once as faces only store indices.
+    void ParseChunk( ObjChunk               & chunk,
+                     ObjAttributes const    & attributes,
+                     ObjTotals const        & totals,
+                     bool                     parse_attributes,
+                     bool                     shared_indices,
+                     InterleavedMesh        * faces ) {
+      std::vector<ObjCorner> corners;
+      uint64_t position_index = chunk.PositionBase;
+      uint64_t normal_index = chunk.NormalBase;
+      uint64_t texcoord_index = chunk.TexcoordBase;
+      uint64_t triangle_index = chunk.TriangleBase;
+
+      char const * cursor = chunk.Begin;
+      while( cursor < chunk.End ) {
+        bool valid = true;
+        switch( ReadLineType( cursor, chunk.End ) ) {
+        case ObjLineType::Position:
+          if( parse_attributes ) {
+            valid = ParseAttribute( cursor, chunk.End, attributes.Positions + attributes.PositionStride * position_index, 3 );
+          }
+          ++position_index;
+          break;
+        case ObjLineType::Texcoord:
+          if( parse_attributes ) {
+            valid = ParseAttribute( cursor, chunk.End, attributes.Texcoords + attributes.TexcoordStride * texcoord_index, 2 );
+          }
+          ++texcoord_index;
+          break;
+        case ObjLineType::Normal:
+          if( parse_attributes ) {
+            valid = ParseAttribute( cursor, chunk.End, attributes.Normals + attributes.NormalStride * normal_index, 3 );
+          }
+          ++normal_index;
+          break;
+        case ObjLineType::Face:
+          if( nullptr == faces ) {
+            break;
+          }
+          valid = ParseFace( cursor, chunk.End, corners );
+          for( size_t corner = 2; valid && (corner < corners.size()); ++corner, ++triangle_index ) {
+            ObjCorner const * triangle[3] = { &corners[0], &corners[corner - 1], &corners[corner] };
+            for( uint32_t vertex = 0; valid && (vertex < 3); ++vertex ) {
+              uint64_t output_index = 3 * triangle_index + vertex;
+              uint64_t position;
+              valid = ResolveIndex( triangle[vertex]->Position, position_index, totals.PositionCount, position );
+              if( !valid ) {
+                break;
+              }
+              if( shared_indices ) {
+                valid = ((0 == triangle[vertex]->Texcoord) || (position < totals.TexcoordCount)) &&
+                        ((0 == triangle[vertex]->Normal) || (position < totals.NormalCount));
+                faces->Indices[output_index] = static_cast<uint32_t>(position);
+                continue;
+              }
+
+              float * destination = &faces->Vertices[InterleavedMesh::VertexStride * output_index];
+              memcpy( destination, attributes.Positions + attributes.PositionStride * position, 3 * sizeof( float ) );
+              uint64_t normal;
+              if( 0 != triangle[vertex]->Normal ) {
+                valid = ResolveIndex( triangle[vertex]->Normal, normal_index, totals.NormalCount, normal );
+                if( valid ) {
+                  memcpy( destination + 3, attributes.Normals + attributes.NormalStride * normal, 3 * sizeof( float ) );
+                }
+              }
+              uint64_t texcoord;
+              if( valid &&
+                  (0 != triangle[vertex]->Texcoord) ) {
+                valid = ResolveIndex( triangle[vertex]->Texcoord, texcoord_index, totals.TexcoordCount, texcoord );
+                if( valid ) {
+                  memcpy( destination + 6, attributes.Texcoords + attributes.TexcoordStride * texcoord, 2 * sizeof( float ) );
+                }
+              }
+              faces->Indices[output_index] = static_cast<uint32_t>(output_index);
+            }
+          }
+          break;
+        case ObjLineType::Other:
+          break;
+        }
+        if( !valid ) {
+          chunk.Valid = false;
+          return;
+        }
+        SkipLine( cursor, chunk.End );
+      }
+    }
+
+    template<class Function>
+    void ForEachChunk( ThreadPool            & thread_pool,
+                       std::vector<ObjChunk> & chunks,
+                       Function                function ) {
+      std::vector<std::future<void>> tasks;
+      for( auto & chunk : chunks ) {
+        tasks.push_back( thread_pool.Submit( [&chunk, &function]( uint32_t ) {
+          function( chunk );
+        } ) );
+      }
+      for( auto & task : tasks ) {
+        task.get();
+      }
+    }
+
+  } // namespace
+
+  bool LoadInterleavedMeshFromObjFile( std::string const & filename,
+                                       ThreadPool        & thread_pool,
+                                       InterleavedMesh   & mesh ) {
+    mesh.Vertices.clear();
+    mesh.Indices.clear();
+    mesh.HasNormals = false;
+    mesh.HasTexcoords = false;
+
+    MappedFile file;
+    if( !file.Open( filename ) ) {
+      return false;
+    }
+
+    // Chunk borders are moved to the beginning of the next line
+    char const * data = reinterpret_cast<char const *>(file.GetData());
+    char const * data_end = data + file.GetSize();
+    size_t chunk_count = std::max<size_t>( 1, std::min<size_t>( file.GetSize() / MinimalChunkSize, 4 * thread_pool.GetThreadCount() ) );
+    std::vector<ObjChunk> chunks;
+    char const * chunk_begin = data;
+    for( size_t index = 1; index <= chunk_count; ++index ) {
+      char const * chunk_end = data_end;
+      if( index < chunk_count ) {
+        chunk_end = std::max( chunk_begin, data + index * (file.GetSize() / chunk_count) );
+        SkipLine( chunk_end, data_end );
+      }
+      if( chunk_end > chunk_begin ) {
+        chunks.push_back( { chunk_begin, chunk_end, 0, 0, 0, 0, 0, 0, 0, 0, true, true } );
+      }
+      chunk_begin = chunk_end;
+    }
+
+    ForEachChunk( thread_pool, chunks, CountChunk );
+
+    ObjTotals totals = { 0, 0, 0 };
+    uint64_t triangle_count = 0;
+    bool shared_indices = true;
+    for( auto & chunk : chunks ) {
+      if( !chunk.Valid ) {
+        std::cout << "Could not parse faces of the '" << filename << "' file." << std::endl;
+        return false;
+      }
+      chunk.PositionBase = totals.PositionCount;
+      chunk.NormalBase = totals.NormalCount;
+      chunk.TexcoordBase = totals.TexcoordCount;
+      chunk.TriangleBase = triangle_count;
+      totals.PositionCount += chunk.PositionCount;
+      totals.NormalCount += chunk.NormalCount;
+      totals.TexcoordCount += chunk.TexcoordCount;
+      triangle_count += chunk.TriangleCount;
+      shared_indices = shared_indices && chunk.SharedIndices;
+    }
+    shared_indices = shared_indices &&
+                     (totals.NormalCount <= totals.PositionCount) &&
+                     (totals.TexcoordCount <= totals.PositionCount);
+
+    uint64_t vertex_count = shared_indices ? totals.PositionCount : 3 * triangle_count;
+    if( vertex_count > UINT32_MAX ) {
+      std::cout << "The '" << filename << "' file has too many vertices for 32-bit indices." << std::endl;
+      return false;
+    }
+
+    mesh.Vertices.resize( static_cast<size_t>(InterleavedMesh::VertexStride * vertex_count) );
+    mesh.Indices.resize( static_cast<size_t>(3 * triangle_count) );
+    mesh.HasNormals = totals.NormalCount > 0;
+    mesh.HasTexcoords = totals.TexcoordCount > 0;
+
+    if( shared_indices ) {
+      // Attributes go straight into the interleaved vertices
+      ObjAttributes attributes = {
+        mesh.Vertices.data(),           // float    * Positions
+        InterleavedMesh::VertexStride,  // uint32_t   PositionStride
+        mesh.Vertices.data() + 3,       // float    * Normals
+        InterleavedMesh::VertexStride,  // uint32_t   NormalStride
+        mesh.Vertices.data() + 6,       // float    * Texcoords
+        InterleavedMesh::VertexStride   // uint32_t   TexcoordStride
+      };
+      ForEachChunk( thread_pool, chunks, [&]( ObjChunk & chunk ) {
+        ParseChunk( chunk, attributes, totals, true, true, &mesh );
+      } );
+    } else {
+      std::vector<float> positions( static_cast<size_t>(3 * totals.PositionCount) );
+      std::vector<float> normals( static_cast<size_t>(3 * totals.NormalCount) );
+      std::vector<float> texcoords( static_cast<size_t>(2 * totals.TexcoordCount) );
+      ObjAttributes attributes = {
+        positions.data(),   // float    * Positions
+        3,                  // uint32_t   PositionStride
+        normals.data(),     // float    * Normals
+        3,                  // uint32_t   NormalStride
+        texcoords.data(),   // float    * Texcoords
+        2                   // uint32_t   TexcoordStride
+      };
+      ForEachChunk( thread_pool, chunks, [&]( ObjChunk & chunk ) {
+        ParseChunk( chunk, attributes, totals, true, false, nullptr );
+      } );
+      // Faces may reference attributes from any chunk, so they are gathered in a separate pass
+      if( std::all_of( chunks.begin(), chunks.end(), []( ObjChunk const & chunk ) { return chunk.Valid; } ) ) {
+        ForEachChunk( thread_pool, chunks, [&]( ObjChunk & chunk ) {
+          ParseChunk( chunk, attributes, totals, false, false, &mesh );
+        } );
+      }
+    }
+
+    bool valid = true;
+    for( auto & chunk : chunks ) {
+      valid = valid && chunk.Valid;
+    }
+    if( !valid ) {
+      std::cout << "The '" << filename << "' file contains invalid elements." << std::endl;
+      mesh.Vertices.clear();
+      mesh.Indices.clear();
+      return false;
+    }
+    return true;
+  }
+
+} // namespace VulkanCookbook
@@ -0,0 +1,182 @@
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Offscreen Rendering
+
+#include "Offscreen.h"
+#include "Resources.h"
+#include <fstream>
+
+namespace VulkanCookbook {
+
+  bool CreateOffscreenRenderTarget( DeviceDispatch const  & dispatch,
+                                    DeviceMemoryAllocator & allocator,
+                                    VkFormat                format,
+                                    VkExtent2D              size,
+                                    OffscreenRenderTarget & render_target ) {
+    render_target.Format = format;
+    render_target.Size = size;
+
+    InitVkDestroyer( dispatch, render_target.Image );
+    if( !CreateImage( dispatch, VK_IMAGE_TYPE_2D, format, { size.width, size.height, 1 }, 1, 1, VK_SAMPLE_COUNT_1_BIT,
+                      VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT, false, *render_target.Image ) ) {
+      return false;
+    }
+    if( !AllocateAndBindMemoryObjectToImage( allocator, *render_target.Image, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, VK_IMAGE_TILING_OPTIMAL, render_target.ImageMemory ) ) {
+      return false;
+    }
+
+    InitVkDestroyer( dispatch, render_target.ReadbackBuffer );
+    if( !CreateBuffer( dispatch, 4 * static_cast<VkDeviceSize>(size.width) * size.height, VK_BUFFER_USAGE_TRANSFER_DST_BIT, *render_target.ReadbackBuffer ) ) {
+      return false;
+    }
+    // Cached memory makes reading the pixels on the CPU much faster; fall back to any host visible type
+    if( !AllocateAndBindMemoryObjectToBuffer( allocator, *render_target.ReadbackBuffer, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT, render_target.ReadbackMemory ) &&
+        !AllocateAndBindMemoryObjectToBuffer( allocator, *render_target.ReadbackBuffer, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, render_target.ReadbackMemory ) ) {
+      return false;
+    }
+    return true;
+  }
+
+  void RecordOffscreenFrame( DeviceDispatch const                            & dispatch,
+                             VkCommandBuffer                                   command_buffer,
+                             OffscreenRenderTarget                           & render_target,
+                             std::function<void( VkCommandBuffer, VkImage )>   record_commands ) {
+    // Previous contents are discarded; record_commands gets the image in the transfer destination layout
+    SetImageMemoryBarrier( dispatch, command_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, { {
+      *render_target.Image,                   // VkImage              Image
+      0,                                      // VkAccessFlags        CurrentAccess
+      VK_ACCESS_TRANSFER_WRITE_BIT,           // VkAccessFlags        NewAccess
+      VK_IMAGE_LAYOUT_UNDEFINED,              // VkImageLayout        CurrentLayout
+      VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,   // VkImageLayout        NewLayout
+      VK_QUEUE_FAMILY_IGNORED,                // uint32_t             CurrentQueueFamily
+      VK_QUEUE_FAMILY_IGNORED,                // uint32_t             NewQueueFamily
+      VK_IMAGE_ASPECT_COLOR_BIT               // VkImageAspectFlags   Aspect
+    } } );
+
+    if( record_commands ) {
+      record_commands( command_buffer, *render_target.Image );
+    }
+
+    SetImageMemoryBarrier( dispatch, command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, { {
+      *render_target.Image,                                                   // VkImage              Image
+      VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,    // VkAccessFlags        CurrentAccess
+      VK_ACCESS_TRANSFER_READ_BIT,                                            // VkAccessFlags        NewAccess
+      VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,                                   // VkImageLayout        CurrentLayout
+      VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,                                   // VkImageLayout        NewLayout
+      VK_QUEUE_FAMILY_IGNORED,                                                // uint32_t             CurrentQueueFamily
+      VK_QUEUE_FAMILY_IGNORED,                                                // uint32_t             NewQueueFamily
+      VK_IMAGE_ASPECT_COLOR_BIT                                               // VkImageAspectFlags   Aspect
+    } } );
+
+    VkBufferImageCopy region = {
+      0,                                  // VkDeviceSize               bufferOffset
+      0,                                  // uint32_t                   bufferRowLength
+      0,                                  // uint32_t                   bufferImageHeight
+      {                                   // VkImageSubresourceLayers   imageSubresource
+        VK_IMAGE_ASPECT_COLOR_BIT,            // VkImageAspectFlags         aspectMask
+        0,                                    // uint32_t                   mipLevel
+        0,                                    // uint32_t                   baseArrayLayer
+        1                                     // uint32_t                   layerCount
+      },
+      { 0, 0, 0 },                        // VkOffset3D                 imageOffset
+      {                                   // VkExtent3D                 imageExtent
+        render_target.Size.width,
+        render_target.Size.height,
+        1
+      }
+    };
+    dispatch.vkCmdCopyImageToBuffer( command_buffer, *render_target.Image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, *render_target.ReadbackBuffer, 1, &region );
+
+    // Make the copied data available to the host after the fence is signaled
+    SetBufferMemoryBarrier( dispatch, command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, { {
+      *render_target.ReadbackBuffer,    // VkBuffer         Buffer
+      VK_ACCESS_TRANSFER_WRITE_BIT,     // VkAccessFlags    CurrentAccess
+      VK_ACCESS_HOST_READ_BIT,          // VkAccessFlags    NewAccess
+      VK_QUEUE_FAMILY_IGNORED,          // uint32_t         CurrentQueueFamily
+      VK_QUEUE_FAMILY_IGNORED           // uint32_t         NewQueueFamily
+    } } );
+  }
+
+  bool ReadOffscreenRenderTarget( DeviceMemoryAllocator      & allocator,
+                                  OffscreenRenderTarget      & render_target,
+                                  std::vector<unsigned char> & pixels ) {
+    MemoryAllocation allocation = *render_target.ReadbackMemory;
+    if( (nullptr == allocation) ||
+        (nullptr == allocation->Data) ) {
+      std::cout << "Offscreen readback buffer is not mapped." << std::endl;
+      return false;
+    }
+    if( !allocator.InvalidateMappedRange( allocation ) ) {
+      return false;
+    }
+
+    size_t data_size = 4 * static_cast<size_t>(render_target.Size.width) * render_target.Size.height;
+    pixels.resize( data_size );
+    std::memcpy( pixels.data(), allocation->Data, data_size );
+
+    switch( render_target.Format ) {
+    case VK_FORMAT_B8G8R8A8_UNORM:
+    case VK_FORMAT_B8G8R8A8_SRGB:
+      for( size_t i = 0; i < data_size; i += 4 ) {
+        std::swap( pixels[i], pixels[i + 2] );
+      }
+      break;
+    default:
+      break;
+    }
+    return true;
+  }
+
+  bool SaveImageAsPpm( std::string const                & filename,
+                       VkExtent2D                         size,
+                       std::vector<unsigned char> const & rgba_pixels ) {
+    if( rgba_pixels.size() < 4 * static_cast<size_t>(size.width) * size.height ) {
+      std::cout << "Not enough pixel data to save image '" << filename << "'." << std::endl;
+      return false;
+    }
+
+    std::ofstream file( filename, std::ios::binary );
+    if( file.fail() ) {
+      std::cout << "Could not open '" << filename << "' file." << std::endl;
+      return false;
+    }
+
+    file << "P6\n" << size.width << " " << size.height << "\n255\n";
+
+    std::vector<unsigned char> row( 3 * static_cast<size_t>(size.width) );
+    for( uint32_t y = 0; y < size.height; ++y ) {
+      unsigned char const * source = &rgba_pixels[4 * static_cast<size_t>(y) * size.width];
+      for( uint32_t x = 0; x < size.width; ++x ) {
+        row[3 * x + 0] = source[4 * x + 0];
+        row[3 * x + 1] = source[4 * x + 1];
+        row[3 * x + 2] = source[4 * x + 2];
+      }
+      file.write( reinterpret_cast<char const *>(row.data()), row.size() );
+    }
+
+    if( file.fail() ) {
+      std::cout << "Could not write '" << filename << "' file." << std::endl;
+      return false;
+    }
+    return true;
+  }
+
+} // namespace VulkanCookbook
@@ -0,0 +1,156 @@
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Pipeline Cache
+
+#include <cstdio>
+#include <fstream>
+#include "PipelineCache.h"
+#include "Tools.h"
+
+namespace VulkanCookbook {
+
+  bool CreatePipelineCacheObject( DeviceDispatch const & dispatch,
+                                  ByteSpan               cache_data,
+                                  VkPipelineCache      & pipeline_cache ) {
+    VkPipelineCacheCreateInfo pipeline_cache_create_info = {
+      VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,     // VkStructureType                sType
+      nullptr,                                          // const void                   * pNext
+      0,                                                // VkPipelineCacheCreateFlags     flags
+      cache_data.Size,                                  // size_t                         initialDataSize
+      cache_data.Data                                   // const void                   * pInitialData
+    };
+
+    VkResult result = dispatch.vkCreatePipelineCache( dispatch.Device, &pipeline_cache_create_info, nullptr, &pipeline_cache );
+    if( (VK_SUCCESS != result) ||
+        (VK_NULL_HANDLE == pipeline_cache) ) {
+      std::cout << "Could not create pipeline cache." << std::endl;
+      return false;
+    }
+    return true;
+  }
+
+  bool RetrieveDataFromPipelineCache( DeviceDispatch const       & dispatch,
+                                      VkPipelineCache              pipeline_cache,
+                                      std::vector<unsigned char> & pipeline_cache_data ) {
+    size_t data_size = 0;
+    VkResult result = VK_SUCCESS;
+
+    result = dispatch.vkGetPipelineCacheData( dispatch.Device, pipeline_cache, &data_size, nullptr );
+    if( (VK_SUCCESS != result) ||
+        (0 == data_size) ) {
+      std::cout << "Could not get the size of the pipeline cache." << std::endl;
+      return false;
+    }
+    pipeline_cache_data.resize( data_size );
+
+    result = dispatch.vkGetPipelineCacheData( dispatch.Device, pipeline_cache, &data_size, pipeline_cache_data.data() );
+    if( (VK_SUCCESS != result) ||
+        (0 == data_size) ) {
+      std::cout << "Could not acquire pipeline cache data." << std::endl;
+      return false;
+    }
+    pipeline_cache_data.resize( data_size );
+
+    return true;
+  }
+
+  bool MergeMultiplePipelineCacheObjects( DeviceDispatch const               & dispatch,
+                                          VkPipelineCache                      target_pipeline_cache,
+                                          std::vector<VkPipelineCache> const & source_pipeline_caches ) {
+    if( source_pipeline_caches.size() > 0 ) {
+      VkResult result = dispatch.vkMergePipelineCaches( dispatch.Device, target_pipeline_cache, static_cast<uint32_t>(source_pipeline_caches.size()), source_pipeline_caches.data() );
+      if( VK_SUCCESS != result ) {
+        std::cout << "Could not merge pipeline cache objects." << std::endl;
+        return false;
+      }
+      return true;
+    }
+    return false;
+  }
+
+  bool IsPipelineCacheDataCompatible( ByteSpan                           cache_data,
+                                      VkPhysicalDeviceProperties const & device_properties ) {
+    // uint32_t headerSize, uint32_t headerVersion, uint32_t vendorID, uint32_t deviceID, uint8_t pipelineCacheUUID[VK_UUID_SIZE]
+    size_t const header_size = 4 * sizeof( uint32_t ) + VK_UUID_SIZE;
+    if( cache_data.Size < header_size ) {
+      return false;
+    }
+
+    uint32_t header[4];
+    memcpy( header, cache_data.Data, sizeof( header ) );
+
+    if( (header[0] < header_size) ||
+        (header[0] > cache_data.Size) ||
+        (header[1] != VK_PIPELINE_CACHE_HEADER_VERSION_ONE) ||
+        (header[2] != device_properties.vendorID) ||
+        (header[3] != device_properties.deviceID) ) {
+      return false;
+    }
+    return 0 == memcmp( cache_data.Data + sizeof( header ), device_properties.pipelineCacheUUID, VK_UUID_SIZE );
+  }
+
+  bool LoadPipelineCacheFromFile( DeviceDispatch const             & dispatch,
+                                  VkPhysicalDeviceProperties const & device_properties,
+                                  std::string const                & filename,
+                                  VkPipelineCache                  & pipeline_cache ) {
+    MappedFile file;
+    ByteSpan cache_data;
+
+    // A missing file just means this is the first run
+    if( std::ifstream( filename, std::ios::binary ).good() &&
+        GetBinaryFileContents( filename, file, cache_data, MAPPED_FILE_HINT_SEQUENTIAL_BIT | MAPPED_FILE_HINT_POPULATE_BIT ) ) {
+      if( !IsPipelineCacheDataCompatible( cache_data, device_properties ) ) {
+        std::cout << "Pipeline cache '" << filename << "' was created by a different device or driver, ignoring it." << std::endl;
+        cache_data = ByteSpan();
+      }
+    }
+
+    return CreatePipelineCacheObject( dispatch, cache_data, pipeline_cache );
+  }
+
+  bool SavePipelineCacheToFile( DeviceDispatch const & dispatch,
+                                VkPipelineCache        pipeline_cache,
+                                std::string const    & filename ) {
+    std::vector<unsigned char> cache_data;
+    if( !RetrieveDataFromPipelineCache( dispatch, pipeline_cache, cache_data ) ) {
+      return false;
+    }
+
+    std::string temporary_filename = GetTemporaryFilename( filename );
+    {
+      std::ofstream file( temporary_filename, std::ios::binary | std::ios::trunc );
+      if( file.fail() ) {
+        std::cout << "Could not open '" << temporary_filename << "' file for writing." << std::endl;
+        return false;
+      }
+      file.write( reinterpret_cast<char const *>(cache_data.data()), cache_data.size() );
+      file.close();
+      if( file.fail() ) {
+        std::cout << "Could not write pipeline cache to '" << temporary_filename << "' file." << std::endl;
+        std::remove( temporary_filename.c_str() );
+        return false;
+      }
+    }
+
+    return ReplaceFileAtomically( temporary_filename, filename );
+  }
+
+} // namespace VulkanCookbook
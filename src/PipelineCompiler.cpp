@@ -0,0 +1,132 @@
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Pipeline Compiler
+
+#include "PipelineCompiler.h"
+#include "PipelineCache.h"
+
+namespace VulkanCookbook {
+
+  namespace {
+
+    std::shared_future<VkPipeline> MakeFailedCompilation() {
+      std::promise<VkPipeline> pipeline;
+      pipeline.set_value( VK_NULL_HANDLE );
+      return pipeline.get_future().share();
+    }
+
+  } // namespace
+
+  PipelineCompiler::PipelineCompiler() :
+    Dispatch( nullptr ),
+    MasterPipelineCache( VK_NULL_HANDLE ) {
+  }
+
+  PipelineCompiler::~PipelineCompiler() {
+    Finish();
+  }
+
+  bool PipelineCompiler::Initialize( DeviceDispatch const & dispatch,
+                                     VkPipelineCache        master_pipeline_cache,
+                                     uint32_t               thread_count ) {
+    Finish();
+
+    Dispatch = &dispatch;
+    MasterPipelineCache = master_pipeline_cache;
+    Workers.reset( new ThreadPool( thread_count ) );
+
+    // Seed every worker cache with what the master cache already knows
+    std::vector<unsigned char> cache_data;
+    if( VK_NULL_HANDLE != MasterPipelineCache ) {
+      RetrieveDataFromPipelineCache( *Dispatch, MasterPipelineCache, cache_data );
+    }
+
+    WorkerPipelineCaches.resize( Workers->GetThreadCount(), VK_NULL_HANDLE );
+    for( auto & worker_pipeline_cache : WorkerPipelineCaches ) {
+      if( !CreatePipelineCacheObject( *Dispatch, cache_data, worker_pipeline_cache ) ) {
+        Finish();
+        return false;
+      }
+    }
+    return true;
+  }
+
+  std::shared_future<VkPipeline> PipelineCompiler::CompileGraphicsPipeline( VkGraphicsPipelineCreateInfo const & create_info ) {
+    if( !Workers ) {
+      std::cout << "Pipeline compiler is not initialized." << std::endl;
+      return MakeFailedCompilation();
+    }
+    VkGraphicsPipelineCreateInfo const * create_info_pointer = &create_info;
+    return Workers->Submit( [this, create_info_pointer]( uint32_t worker_index ) {
+      VkPipeline pipeline = VK_NULL_HANDLE;
+      VkResult result = Dispatch->vkCreateGraphicsPipelines( Dispatch->Device, WorkerPipelineCaches[worker_index], 1, create_info_pointer, nullptr, &pipeline );
+      if( VK_SUCCESS != result ) {
+        std::cout << "Could not create a graphics pipeline." << std::endl;
+        return static_cast<VkPipeline>(VK_NULL_HANDLE);
+      }
+      return pipeline;
+    } ).share();
+  }
+
+  std::shared_future<VkPipeline> PipelineCompiler::CompileComputePipeline( VkComputePipelineCreateInfo const & create_info ) {
+    if( !Workers ) {
+      std::cout << "Pipeline compiler is not initialized." << std::endl;
+      return MakeFailedCompilation();
+    }
+    VkComputePipelineCreateInfo const * create_info_pointer = &create_info;
+    return Workers->Submit( [this, create_info_pointer]( uint32_t worker_index ) {
+      VkPipeline pipeline = VK_NULL_HANDLE;
+      VkResult result = Dispatch->vkCreateComputePipelines( Dispatch->Device, WorkerPipelineCaches[worker_index], 1, create_info_pointer, nullptr, &pipeline );
+      if( VK_SUCCESS != result ) {
+        std::cout << "Could not create a compute pipeline." << std::endl;
+        return static_cast<VkPipeline>(VK_NULL_HANDLE);
+      }
+      return pipeline;
+    } ).share();
+  }
+
+  bool PipelineCompiler::Finish() {
+    if( !Workers ) {
+      return true;
+    }
+    Workers->WaitIdle();
+
+    bool result = true;
+    std::vector<VkPipelineCache> source_pipeline_caches;
+    for( auto & worker_pipeline_cache : WorkerPipelineCaches ) {
+      if( VK_NULL_HANDLE != worker_pipeline_cache ) {
+        source_pipeline_caches.push_back( worker_pipeline_cache );
+      }
+    }
+    if( (VK_NULL_HANDLE != MasterPipelineCache) &&
+        (source_pipeline_caches.size() > 0) ) {
+      result = MergeMultiplePipelineCacheObjects( *Dispatch, MasterPipelineCache, source_pipeline_caches );
+    }
+
+    for( auto & worker_pipeline_cache : source_pipeline_caches ) {
+      Dispatch->vkDestroyPipelineCache( Dispatch->Device, worker_pipeline_cache, nullptr );
+    }
+    WorkerPipelineCaches.clear();
+    Workers.reset();
+    return result;
+  }
+
+} // namespace VulkanCookbook
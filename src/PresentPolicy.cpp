@@ -0,0 +1,143 @@
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Present Policy
+
+#include "PresentPolicy.h"
+#include "FrameLoop.h"
+
+namespace VulkanCookbook {
+
+  namespace {
+
+    struct PresentProfileDescription {
+      PresentProfile                  Profile;
+      char const                    * Name;
+      std::vector<VkPresentModeKHR>   PreferredModes;
+      uint32_t                        FramesInFlight;
+    };
+
+    std::vector<PresentProfileDescription> const & GetPresentProfileDescriptions() {
+      static std::vector<PresentProfileDescription> const descriptions = {
+        // A single frame in flight would serialize the CPU and the GPU, so it is left to --frames-in-flight 1
+        { PresentProfile::LowLatency, "low-latency", { VK_PRESENT_MODE_MAILBOX_KHR, VK_PRESENT_MODE_IMMEDIATE_KHR }, FrameLoop::DefaultFramesInFlight },
+        { PresentProfile::Throughput, "throughput",  { VK_PRESENT_MODE_FIFO_KHR },                                   3 },
+        { PresentProfile::PowerSave,  "power-save",  { VK_PRESENT_MODE_FIFO_RELAXED_KHR },                           2 }
+      };
+      return descriptions;
+    }
+
+    PresentProfileDescription const & GetPresentProfileDescription( PresentProfile profile ) {
+      for( auto & description : GetPresentProfileDescriptions() ) {
+        if( description.Profile == profile ) {
+          return description;
+        }
+      }
+      return GetPresentProfileDescriptions().front();
+    }
+
+  } // namespace
+
+  bool ParsePresentProfile( char const     * name,
+                            PresentProfile & profile ) {
+    for( auto & description : GetPresentProfileDescriptions() ) {
+      if( 0 == strcmp( description.Name, name ) ) {
+        profile = description.Profile;
+        return true;
+      }
+    }
+    std::cout << "Unknown present profile '" << name << "'. Available profiles:";
+    for( auto & description : GetPresentProfileDescriptions() ) {
+      std::cout << " " << description.Name;
+    }
+    std::cout << std::endl;
+    return false;
+  }
+
+  char const * GetPresentProfileName( PresentProfile profile ) {
+    return GetPresentProfileDescription( profile ).Name;
+  }
+
+  bool SelectPresentModeForProfile( VkPhysicalDevice   physical_device,
+                                    VkSurfaceKHR       presentation_surface,
+                                    PresentProfile     profile,
+                                    VkPresentModeKHR & present_mode ) {
+    uint32_t present_modes_count = 0;
+    VkResult result = VK_SUCCESS;
+
+    result = vkGetPhysicalDeviceSurfacePresentModesKHR( physical_device, presentation_surface, &present_modes_count, nullptr );
+    if( (VK_SUCCESS != result) ||
+        (0 == present_modes_count) ) {
+      std::cout << "Could not get the number of supported present modes." << std::endl;
+      return false;
+    }
+
+    std::vector<VkPresentModeKHR> present_modes( present_modes_count );
+    result = vkGetPhysicalDeviceSurfacePresentModesKHR( physical_device, presentation_surface, &present_modes_count, present_modes.data() );
+    if( (VK_SUCCESS != result) ||
+        (0 == present_modes_count) ) {
+      std::cout << "Could not enumerate present modes." << std::endl;
+      return false;
+    }
+
+    for( auto & preferred_mode : GetPresentProfileDescription( profile ).PreferredModes ) {
+      for( auto & current_present_mode : present_modes ) {
+        if( current_present_mode == preferred_mode ) {
+          present_mode = preferred_mode;
+          return true;
+        }
+      }
+    }
+
+    std::cout << "No present mode preferred by the '" << GetPresentProfileName( profile ) << "' profile is supported. Selecting default FIFO mode." << std::endl;
+    present_mode = VK_PRESENT_MODE_FIFO_KHR;
+    return true;
+  }
+
+  bool SelectNumberOfSwapchainImagesForProfile( VkSurfaceCapabilitiesKHR const & surface_capabilities,
+                                                PresentProfile                   profile,
+                                                VkPresentModeKHR                 present_mode,
+                                                uint32_t                       & number_of_images ) {
+    switch( profile ) {
+    case PresentProfile::LowLatency:
+      // MAILBOX needs a spare image to replace the queued one without blocking
+      number_of_images = surface_capabilities.minImageCount + ((VK_PRESENT_MODE_MAILBOX_KHR == present_mode) ? 1 : 0);
+      break;
+    case PresentProfile::Throughput:
+      number_of_images = surface_capabilities.minImageCount + 2;
+      break;
+    case PresentProfile::PowerSave:
+    default:
+      number_of_images = surface_capabilities.minImageCount + 1;
+      break;
+    }
+
+    if( (surface_capabilities.maxImageCount > 0) &&
+        (number_of_images > surface_capabilities.maxImageCount) ) {
+      number_of_images = surface_capabilities.maxImageCount;
+    }
+    return true;
+  }
+
+  uint32_t GetFramesInFlightForProfile( PresentProfile profile ) {
+    return GetPresentProfileDescription( profile ).FramesInFlight;
+  }
+
+} // namespace VulkanCookbook
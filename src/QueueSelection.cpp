@@ -0,0 +1,142 @@
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Queue Selection
+
+#include "QueueSelection.h"
+#include <bitset>
+
+namespace VulkanCookbook {
+
+  namespace {
+
+    VkQueueFlags GetEffectiveQueueFlags( VkQueueFlags flags ) {
+      // Transfer support is implied by, but need not be reported for, graphics and compute families
+      if( flags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT) ) {
+        flags |= VK_QUEUE_TRANSFER_BIT;
+      }
+      return flags;
+    }
+
+  } // namespace
+
+  bool SelectPreferredQueueFamily( std::vector<VkQueueFamilyProperties> const & queue_families,
+                                   VkQueueFlags                                 desired_capabilities,
+                                   VkQueueFlags                                 undesired_capabilities,
+                                   uint32_t                                   & queue_family_index ) {
+    size_t best_extra_capabilities = sizeof( VkQueueFlags ) * 8 + 1;
+
+    for( uint32_t index = 0; index < static_cast<uint32_t>(queue_families.size()); ++index ) {
+      VkQueueFlags flags = GetEffectiveQueueFlags( queue_families[index].queueFlags );
+      if( (0 == queue_families[index].queueCount) ||
+          ((flags & desired_capabilities) != desired_capabilities) ) {
+        continue;
+      }
+      size_t extra_capabilities = std::bitset<sizeof( VkQueueFlags ) * 8>( flags & undesired_capabilities ).count();
+      if( extra_capabilities < best_extra_capabilities ) {
+        best_extra_capabilities = extra_capabilities;
+        queue_family_index = index;
+      }
+    }
+    return best_extra_capabilities <= sizeof( VkQueueFlags ) * 8;
+  }
+
+  bool SelectQueueLayout( VkPhysicalDevice   physical_device,
+                          VkSurfaceKHR       presentation_surface,
+                          QueueLayout      & queue_layout ) {
+    uint32_t queue_families_count = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties( physical_device, &queue_families_count, nullptr );
+    if( 0 == queue_families_count ) {
+      std::cout << "Could not get the number of queue families." << std::endl;
+      return false;
+    }
+    std::vector<VkQueueFamilyProperties> queue_families( queue_families_count );
+    vkGetPhysicalDeviceQueueFamilyProperties( physical_device, &queue_families_count, queue_families.data() );
+
+    uint32_t graphics_family;
+    uint32_t compute_family;
+    uint32_t transfer_family;
+    if( !SelectPreferredQueueFamily( queue_families, VK_QUEUE_GRAPHICS_BIT, 0, graphics_family ) ||
+        !SelectPreferredQueueFamily( queue_families, VK_QUEUE_COMPUTE_BIT, VK_QUEUE_GRAPHICS_BIT, compute_family ) ||
+        !SelectPreferredQueueFamily( queue_families, VK_QUEUE_TRANSFER_BIT, VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT, transfer_family ) ) {
+      std::cout << "Could not find queue families with graphics, compute and transfer capabilities." << std::endl;
+      return false;
+    }
+
+    // Presenting from the graphics queue avoids ownership transfers of swapchain images
+    uint32_t present_family = graphics_family;
+    if( VK_NULL_HANDLE != presentation_surface ) {
+      std::vector<uint32_t> candidates = { graphics_family };
+      for( uint32_t index = 0; index < queue_families_count; ++index ) {
+        candidates.push_back( index );
+      }
+      bool present_family_found = false;
+      for( auto & candidate : candidates ) {
+        VkBool32 presentation_supported = VK_FALSE;
+        VkResult result = vkGetPhysicalDeviceSurfaceSupportKHR( physical_device, candidate, presentation_surface, &presentation_supported );
+        if( (VK_SUCCESS == result) &&
+            (VK_TRUE == presentation_supported) ) {
+          present_family = candidate;
+          present_family_found = true;
+          break;
+        }
+      }
+      if( !present_family_found ) {
+        std::cout << "Could not find a queue family supporting presentation." << std::endl;
+        return false;
+      }
+    }
+
+    // Hand out queue indices per family; roles exceeding the family's queue count share its last queue
+    queue_layout.Requests.clear();
+    auto assign = [&]( uint32_t family_index ) -> QueueAssignment {
+      for( auto & request : queue_layout.Requests ) {
+        if( request.FamilyIndex == family_index ) {
+          if( request.QueueCount < queue_families[family_index].queueCount ) {
+            ++request.QueueCount;
+          }
+          return { family_index, request.QueueCount - 1 };
+        }
+      }
+      queue_layout.Requests.push_back( { family_index, 1 } );
+      return { family_index, 0 };
+    };
+
+    queue_layout.Graphics = assign( graphics_family );
+    queue_layout.Compute = assign( compute_family );
+    queue_layout.Transfer = assign( transfer_family );
+    if( present_family == graphics_family ) {
+      queue_layout.Present = queue_layout.Graphics;
+    } else {
+      queue_layout.Present = assign( present_family );
+    }
+    return true;
+  }
+
+  void GetDeviceQueues( DeviceDispatch const & dispatch,
+                        QueueLayout const    & queue_layout,
+                        DeviceQueues         & queues ) {
+    dispatch.vkGetDeviceQueue( dispatch.Device, queue_layout.Graphics.FamilyIndex, queue_layout.Graphics.QueueIndex, &queues.Graphics );
+    dispatch.vkGetDeviceQueue( dispatch.Device, queue_layout.Compute.FamilyIndex, queue_layout.Compute.QueueIndex, &queues.Compute );
+    dispatch.vkGetDeviceQueue( dispatch.Device, queue_layout.Transfer.FamilyIndex, queue_layout.Transfer.QueueIndex, &queues.Transfer );
+    dispatch.vkGetDeviceQueue( dispatch.Device, queue_layout.Present.FamilyIndex, queue_layout.Present.QueueIndex, &queues.Present );
+  }
+
+} // namespace VulkanCookbook
@@ -0,0 +1,183 @@
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Resources and Memory
+
+
+#include "Resources.h"
+
+namespace VulkanCookbook {
+
+  bool CreateBuffer( DeviceDispatch const & dispatch,
+                     VkDeviceSize           size,
+                     VkBufferUsageFlags     usage,
+                     VkBuffer             & buffer ) {
+    VkBufferCreateInfo buffer_create_info = {
+      VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,   // VkStructureType        sType
+      nullptr,                                // const void           * pNext
+      0,                                      // VkBufferCreateFlags    flags
+      size,                                   // VkDeviceSize           size
+      usage,                                  // VkBufferUsageFlags     usage
+      VK_SHARING_MODE_EXCLUSIVE,              // VkSharingMode          sharingMode
+      0,                                      // uint32_t               queueFamilyIndexCount
+      nullptr                                 // const uint32_t       * pQueueFamilyIndices
+    };
+
+    VkResult result = dispatch.vkCreateBuffer( dispatch.Device, &buffer_create_info, nullptr, &buffer );
+    if( VK_SUCCESS != result ) {
+      std::cout << "Could not create a buffer." << std::endl;
+      return false;
+    }
+    return true;
+  }
+
+  void SetBufferMemoryBarrier( DeviceDispatch const          & dispatch,
+                               VkCommandBuffer                 command_buffer,
+                               VkPipelineStageFlags            generating_stages,
+                               VkPipelineStageFlags            consuming_stages,
+                               std::vector<BufferTransition>   buffer_transitions ) {
+
+    std::vector<VkBufferMemoryBarrier> buffer_memory_barriers;
+
+    for( auto & buffer_transition : buffer_transitions ) {
+      buffer_memory_barriers.push_back( {
+        VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,    // VkStructureType    sType
+        nullptr,                                    // const void       * pNext
+        buffer_transition.CurrentAccess,            // VkAccessFlags      srcAccessMask
+        buffer_transition.NewAccess,                // VkAccessFlags      dstAccessMask
+        buffer_transition.CurrentQueueFamily,       // uint32_t           srcQueueFamilyIndex
+        buffer_transition.NewQueueFamily,           // uint32_t           dstQueueFamilyIndex
+        buffer_transition.Buffer,                   // VkBuffer           buffer
+        0,                                          // VkDeviceSize       offset
+        VK_WHOLE_SIZE                               // VkDeviceSize       size
+      } );
+    }
+
+    if( buffer_memory_barriers.size() > 0 ) {
+      dispatch.vkCmdPipelineBarrier( command_buffer, generating_stages, consuming_stages, 0, 0, nullptr, static_cast<uint32_t>(buffer_memory_barriers.size()), buffer_memory_barriers.data(), 0, nullptr );
+    }
+  }
+
+  bool CreateImage( DeviceDispatch const  & dispatch,
+                    VkImageType             type,
+                    VkFormat                format,
+                    VkExtent3D              size,
+                    uint32_t                num_mipmaps,
+                    uint32_t                num_layers,
+                    VkSampleCountFlagBits   samples,
+                    VkImageUsageFlags       usage_scenarios,
+                    bool                    cubemap,
+                    VkImage               & image ) {
+    VkImageCreateInfo image_create_info = {
+      VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,                // VkStructureType          sType
+      nullptr,                                            // const void             * pNext
+      cubemap ? static_cast<VkImageCreateFlags>(VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT) : 0u, // VkImageCreateFlags       flags
+      type,                                               // VkImageType              imageType
+      format,                                             // VkFormat                 format
+      size,                                               // VkExtent3D               extent
+      num_mipmaps,                                        // uint32_t                 mipLevels
+      cubemap ? 6 * num_layers : num_layers,              // uint32_t                 arrayLayers
+      samples,                                            // VkSampleCountFlagBits    samples
+      VK_IMAGE_TILING_OPTIMAL,                            // VkImageTiling            tiling
+      usage_scenarios,                                    // VkImageUsageFlags        usage
+      VK_SHARING_MODE_EXCLUSIVE,                          // VkSharingMode            sharingMode
+      0,                                                  // uint32_t                 queueFamilyIndexCount
+      nullptr,                                            // const uint32_t         * pQueueFamilyIndices
+      VK_IMAGE_LAYOUT_UNDEFINED                           // VkImageLayout            initialLayout
+    };
+
+    VkResult result = dispatch.vkCreateImage( dispatch.Device, &image_create_info, nullptr, &image );
+    if( VK_SUCCESS != result ) {
+      std::cout << "Could not create an image." << std::endl;
+      return false;
+    }
+    return true;
+  }
+
+  bool CreateImageView( DeviceDispatch const & dispatch,
+                        VkImage                image,
+                        VkImageViewType        view_type,
+                        VkFormat               format,
+                        VkImageAspectFlags     aspect,
+                        VkImageView          & image_view ) {
+    VkImageViewCreateInfo image_view_create_info = {
+      VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,   // VkStructureType            sType
+      nullptr,                                    // const void               * pNext
+      0,                                          // VkImageViewCreateFlags     flags
+      image,                                      // VkImage                    image
+      view_type,                                  // VkImageViewType            viewType
+      format,                                     // VkFormat                   format
+      {                                           // VkComponentMapping         components
+        VK_COMPONENT_SWIZZLE_IDENTITY,                // VkComponentSwizzle         r
+        VK_COMPONENT_SWIZZLE_IDENTITY,                // VkComponentSwizzle         g
+        VK_COMPONENT_SWIZZLE_IDENTITY,                // VkComponentSwizzle         b
+        VK_COMPONENT_SWIZZLE_IDENTITY                 // VkComponentSwizzle         a
+      },
+      {                                           // VkImageSubresourceRange    subresourceRange
+        aspect,                                       // VkImageAspectFlags         aspectMask
+        0,                                            // uint32_t                   baseMipLevel
+        VK_REMAINING_MIP_LEVELS,                      // uint32_t                   levelCount
+        0,                                            // uint32_t                   baseArrayLayer
+        VK_REMAINING_ARRAY_LAYERS                     // uint32_t                   layerCount
+      }
+    };
+
+    VkResult result = dispatch.vkCreateImageView( dispatch.Device, &image_view_create_info, nullptr, &image_view );
+    if( VK_SUCCESS != result ) {
+      std::cout << "Could not create an image view." << std::endl;
+      return false;
+    }
+    return true;
+  }
+
+  void SetImageMemoryBarrier( DeviceDispatch const         & dispatch,
+                              VkCommandBuffer                command_buffer,
+                              VkPipelineStageFlags           generating_stages,
+                              VkPipelineStageFlags           consuming_stages,
+                              std::vector<ImageTransition>   image_transitions ) {
+    std::vector<VkImageMemoryBarrier> image_memory_barriers;
+
+    for( auto & image_transition : image_transitions ) {
+      image_memory_barriers.push_back( {
+        VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,   // VkStructureType            sType
+        nullptr,                                  // const void               * pNext
+        image_transition.CurrentAccess,           // VkAccessFlags              srcAccessMask
+        image_transition.NewAccess,               // VkAccessFlags              dstAccessMask
+        image_transition.CurrentLayout,           // VkImageLayout              oldLayout
+        image_transition.NewLayout,               // VkImageLayout              newLayout
+        image_transition.CurrentQueueFamily,      // uint32_t                   srcQueueFamilyIndex
+        image_transition.NewQueueFamily,          // uint32_t                   dstQueueFamilyIndex
+        image_transition.Image,                   // VkImage                    image
+        {                                         // VkImageSubresourceRange    subresourceRange
+          image_transition.Aspect,                    // VkImageAspectFlags         aspectMask
+          0,                                          // uint32_t                   baseMipLevel
+          VK_REMAINING_MIP_LEVELS,                    // uint32_t                   levelCount
+          0,                                          // uint32_t                   baseArrayLayer
+          VK_REMAINING_ARRAY_LAYERS                   // uint32_t                   layerCount
+        }
+      } );
+    }
+
+    if( image_memory_barriers.size() > 0 ) {
+      dispatch.vkCmdPipelineBarrier( command_buffer, generating_stages, consuming_stages, 0, 0, nullptr, 0, nullptr, static_cast<uint32_t>(image_memory_barriers.size()), image_memory_barriers.data() );
+    }
+  }
+
+} // namespace VulkanCookbook
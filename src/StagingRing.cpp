@@ -0,0 +1,405 @@
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Staging Ring
+
+#include "StagingRing.h"
+#include "CommandBuffers.h"
+#include "Resources.h"
+#include <algorithm>
+
+namespace VulkanCookbook {
+
+  namespace {
+
+    uint64_t const UnsetOffset = UINT64_MAX;
+
+  } // namespace
+
+  StagingRing::StagingRing() :
+    Dispatch( nullptr ),
+    Allocator( nullptr ),
+    Tracker( nullptr ),
+    TransferQueueFamily( 0 ),
+    TransferQueue( VK_NULL_HANDLE ),
+    Batcher( nullptr ),
+    Size( 0 ),
+    Data( nullptr ),
+    RecordingBatch( 0 ),
+    Recording( false ),
+    Head( 0 ),
+    Tail( 0 ),
+    NextBatchId( 1 ),
+    CompletedBatchId( 0 ) {
+  }
+
+  StagingRing::~StagingRing() {
+    Destroy();
+  }
+
+  bool StagingRing::Initialize( DeviceDispatch const  & dispatch,
+                                DeviceMemoryAllocator & allocator,
+                                CompletionTracker     & completion_tracker,
+                                uint32_t                transfer_queue_family,
+                                VkQueue                 transfer_queue,
+                                VkDeviceSize            size,
+                                uint32_t                batch_count,
+                                SubmitBatcher         * submit_batcher ) {
+    Destroy();
+
+    Dispatch = &dispatch;
+    Allocator = &allocator;
+    Tracker = &completion_tracker;
+    TransferQueueFamily = transfer_queue_family;
+    TransferQueue = transfer_queue;
+    Batcher = submit_batcher;
+    Size = size;
+    RecordingBatch = 0;
+    Recording = false;
+    Head = 0;
+    Tail = 0;
+    NextBatchId = 1;
+    CompletedBatchId = 0;
+
+    InitVkDestroyer( *Dispatch, Buffer );
+    if( !CreateBuffer( *Dispatch, Size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, *Buffer ) ) {
+      Destroy();
+      return false;
+    }
+    // Coherent memory saves the flushes, but any host visible type will do
+    if( !AllocateAndBindMemoryObjectToBuffer( allocator, *Buffer, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, BufferMemory ) &&
+        !AllocateAndBindMemoryObjectToBuffer( allocator, *Buffer, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, BufferMemory ) ) {
+      Destroy();
+      return false;
+    }
+    Data = static_cast<unsigned char *>((*BufferMemory)->Data);
+
+    InitVkDestroyer( *Dispatch, CommandPool );
+    if( !CreateCommandPool( *Dispatch, VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT, TransferQueueFamily, *CommandPool ) ) {
+      Destroy();
+      return false;
+    }
+
+    std::vector<VkCommandBuffer> command_buffers;
+    if( !AllocateCommandBuffers( *Dispatch, *CommandPool, VK_COMMAND_BUFFER_LEVEL_PRIMARY, std::max( batch_count, 1u ), command_buffers ) ) {
+      Destroy();
+      return false;
+    }
+
+    Batches.resize( command_buffers.size() );
+    for( size_t i = 0; i < Batches.size(); ++i ) {
+      Batches[i].CommandBuffer = command_buffers[i];
+    }
+    return true;
+  }
+
+  void StagingRing::Destroy() {
+    if( nullptr == Dispatch ) {
+      return;
+    }
+    if( Recording ) {
+      Flush();
+    }
+    WaitIdle();
+
+    SubmittedBatches.clear();
+    Batches.clear();
+    CommandPool = VkDestroyer(VkCommandPool)();
+    Data = nullptr;
+    Buffer = VkDestroyer(VkBuffer)();
+    BufferMemory = VkDestroyer(MemoryAllocation)();
+    Allocator = nullptr;
+    Tracker = nullptr;
+    Batcher = nullptr;
+    Dispatch = nullptr;
+  }
+
+  bool StagingRing::UploadToBuffer( void const   * data,
+                                    VkDeviceSize   size,
+                                    VkBuffer       destination_buffer,
+                                    VkDeviceSize   destination_offset,
+                                    uint32_t       destination_queue_family ) {
+    VkDeviceSize offset;
+    if( !Allocate( size, DefaultAlignment, offset ) ) {
+      return false;
+    }
+    VkDeviceSize ring_offset = offset % Size;
+    std::memcpy( Data + ring_offset, data, static_cast<size_t>(size) );
+
+    VkCommandBuffer command_buffer = Batches[RecordingBatch].CommandBuffer;
+
+    VkBufferCopy region = {
+      ring_offset,          // VkDeviceSize   srcOffset
+      destination_offset,   // VkDeviceSize   dstOffset
+      size                  // VkDeviceSize   size
+    };
+    Dispatch->vkCmdCopyBuffer( command_buffer, *Buffer, destination_buffer, 1, &region );
+
+    if( (VK_QUEUE_FAMILY_IGNORED != destination_queue_family) &&
+        (TransferQueueFamily != destination_queue_family) ) {
+      SetBufferMemoryBarrier( *Dispatch, command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, { {
+        destination_buffer,             // VkBuffer         Buffer
+        VK_ACCESS_TRANSFER_WRITE_BIT,   // VkAccessFlags    CurrentAccess
+        0,                              // VkAccessFlags    NewAccess
+        TransferQueueFamily,            // uint32_t         CurrentQueueFamily
+        destination_queue_family        // uint32_t         NewQueueFamily
+      } } );
+    }
+    return true;
+  }
+
+  bool StagingRing::UploadToImage( void const               * data,
+                                   VkDeviceSize               size,
+                                   VkImage                    destination_image,
+                                   VkImageSubresourceLayers   subresource,
+                                   VkOffset3D                 image_offset,
+                                   VkExtent3D                 image_extent,
+                                   VkImageLayout              final_layout,
+                                   uint32_t                   destination_queue_family ) {
+    VkDeviceSize offset;
+    if( !Allocate( size, DefaultAlignment, offset ) ) {
+      return false;
+    }
+    VkDeviceSize ring_offset = offset % Size;
+    std::memcpy( Data + ring_offset, data, static_cast<size_t>(size) );
+
+    VkCommandBuffer command_buffer = Batches[RecordingBatch].CommandBuffer;
+
+    VkImageSubresourceRange subresource_range = {
+      subresource.aspectMask,       // VkImageAspectFlags     aspectMask
+      subresource.mipLevel,         // uint32_t               baseMipLevel
+      1,                            // uint32_t               levelCount
+      subresource.baseArrayLayer,   // uint32_t               baseArrayLayer
+      subresource.layerCount        // uint32_t               layerCount
+    };
+
+    // Only the uploaded subresource changes its layout, so other mip levels may be streamed separately
+    VkImageMemoryBarrier barrier = {
+      VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,   // VkStructureType            sType
+      nullptr,                                  // const void               * pNext
+      0,                                        // VkAccessFlags              srcAccessMask
+      VK_ACCESS_TRANSFER_WRITE_BIT,             // VkAccessFlags              dstAccessMask
+      VK_IMAGE_LAYOUT_UNDEFINED,                // VkImageLayout              oldLayout
+      VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,     // VkImageLayout              newLayout
+      VK_QUEUE_FAMILY_IGNORED,                  // uint32_t                   srcQueueFamilyIndex
+      VK_QUEUE_FAMILY_IGNORED,                  // uint32_t                   dstQueueFamilyIndex
+      destination_image,                        // VkImage                    image
+      subresource_range                         // VkImageSubresourceRange    subresourceRange
+    };
+    Dispatch->vkCmdPipelineBarrier( command_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier );
+
+    VkBufferImageCopy region = {
+      ring_offset,    // VkDeviceSize               bufferOffset
+      0,              // uint32_t                   bufferRowLength
+      0,              // uint32_t                   bufferImageHeight
+      subresource,    // VkImageSubresourceLayers   imageSubresource
+      image_offset,   // VkOffset3D                 imageOffset
+      image_extent    // VkExtent3D                 imageExtent
+    };
+    Dispatch->vkCmdCopyBufferToImage( command_buffer, *Buffer, destination_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region );
+
+    // Consumers synchronize through the semaphores or fences of the batch,
+    // so the final transition does not need a destination access scope
+    bool release_ownership = (VK_QUEUE_FAMILY_IGNORED != destination_queue_family) &&
+                             (TransferQueueFamily != destination_queue_family);
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = 0;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.newLayout = final_layout;
+    barrier.srcQueueFamilyIndex = release_ownership ? TransferQueueFamily : VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = release_ownership ? destination_queue_family : VK_QUEUE_FAMILY_IGNORED;
+    Dispatch->vkCmdPipelineBarrier( command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier );
+    return true;
+  }
+
+  bool StagingRing::Flush( std::vector<VkSemaphore> const & signal_semaphores ) {
+    if( !Recording ) {
+      if( signal_semaphores.empty() ) {
+        Tracker->Poll();
+        return true;
+      }
+      // Semaphores are promised to the caller, so submit even an empty batch
+      if( !BeginBatch() ) {
+        return false;
+      }
+    }
+
+    StagingBatch & batch = Batches[RecordingBatch];
+    if( !EndCommandBufferRecordingOperation( *Dispatch, batch.CommandBuffer ) ) {
+      return false;
+    }
+
+    VkFence fence;
+    uint64_t submission_id;
+    if( !Tracker->BeginSubmission( fence, submission_id ) ) {
+      return false;
+    }
+
+    // Written data may wrap around the end of the ring
+    if( UnsetOffset != batch.Begin ) {
+      VkDeviceSize begin = batch.Begin % Size;
+      VkDeviceSize length = Head - batch.Begin;
+      if( begin + length <= Size ) {
+        Allocator->FlushMappedRange( *BufferMemory, begin, length );
+      } else {
+        Allocator->FlushMappedRange( *BufferMemory, begin, Size - begin );
+        Allocator->FlushMappedRange( *BufferMemory, 0, begin + length - Size );
+      }
+    }
+    batch.End = Head;
+
+    if( nullptr != Batcher ) {
+      SubmitBatch submit_batch;
+      submit_batch.CommandBuffers.push_back( batch.CommandBuffer );
+      for( auto semaphore : signal_semaphores ) {
+        submit_batch.SignalSemaphores.push_back( { semaphore, 0 } );
+      }
+      Batcher->Add( TransferQueue, submit_batch, fence );
+    } else if( !SubmitCommandBuffersToQueue( *Dispatch, TransferQueue, {}, { batch.CommandBuffer }, signal_semaphores, fence ) ) {
+      Tracker->CancelSubmission( submission_id );
+      return false;
+    }
+    batch.SubmissionId = submission_id;
+
+    // Submissions may be reported in any order, while the ring space is reclaimed oldest first
+    uint32_t batch_index = RecordingBatch;
+    Tracker->OnComplete( submission_id, [this, batch_index]() {
+      Batches[batch_index].Complete = true;
+      RetireCompletedBatches();
+    } );
+    SubmittedBatches.push_back( RecordingBatch );
+    RecordingBatch = (RecordingBatch + 1) % static_cast<uint32_t>(Batches.size());
+    ++NextBatchId;
+    Recording = false;
+
+    Tracker->Poll();
+    return true;
+  }
+
+  bool StagingRing::IsBatchComplete( uint64_t batch_id ) {
+    Tracker->Poll();
+    return batch_id <= CompletedBatchId;
+  }
+
+  bool StagingRing::WaitIdle() {
+    while( !SubmittedBatches.empty() ) {
+      if( !RetireOldestBatch() ) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool StagingRing::Allocate( VkDeviceSize     size,
+                              VkDeviceSize     alignment,
+                              VkDeviceSize   & offset ) {
+    if( size > Size ) {
+      std::cout << "Upload of " << size << " bytes does not fit into the staging ring." << std::endl;
+      return false;
+    }
+
+    while( true ) {
+      uint64_t candidate = ((Head + alignment - 1) / alignment) * alignment;
+      uint64_t ring_position = candidate % Size;
+      if( ring_position + size > Size ) {
+        // Skip the end of the ring, a copy source has to be contiguous
+        candidate += Size - ring_position;
+      }
+
+      if( candidate + size - Tail <= Size ) {
+        Head = candidate + size;
+        if( !Recording &&
+            !BeginBatch() ) {
+          return false;
+        }
+        StagingBatch & batch = Batches[RecordingBatch];
+        if( UnsetOffset == batch.Begin ) {
+          batch.Begin = candidate;
+        }
+        offset = candidate;
+        return true;
+      }
+
+      // Make room - oldest data first
+      if( !SubmittedBatches.empty() ) {
+        if( !RetireOldestBatch() ) {
+          return false;
+        }
+      } else if( Recording ) {
+        if( !Flush() ) {
+          return false;
+        }
+      } else {
+        // Nothing is in use, start over at the beginning of the ring
+        Head = ((Head + Size - 1) / Size) * Size;
+        Tail = Head;
+      }
+    }
+  }
+
+  bool StagingRing::BeginBatch() {
+    // Batch slots are reused in submission order, so a busy slot is always the oldest one
+    if( !SubmittedBatches.empty() &&
+        (SubmittedBatches.front() == RecordingBatch) ) {
+      if( !RetireOldestBatch() ) {
+        return false;
+      }
+    }
+
+    StagingBatch & batch = Batches[RecordingBatch];
+    if( !BeginCommandBufferRecordingOperation( *Dispatch, batch.CommandBuffer, VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, nullptr ) ) {
+      return false;
+    }
+    batch.SubmissionId = 0;
+    batch.Complete = false;
+    batch.Id = NextBatchId;
+    batch.Begin = UnsetOffset;
+    batch.End = UnsetOffset;
+    Recording = true;
+    return true;
+  }
+
+  bool StagingRing::RetireOldestBatch() {
+    // Waiting on a fence which is still held by the batcher would never end
+    if( (nullptr != Batcher) &&
+        !Batcher->Flush( TransferQueue ) ) {
+      return false;
+    }
+
+    // The completion callback of the submission retires the batch
+    if( !Tracker->WaitForSubmission( Batches[SubmittedBatches.front()].SubmissionId ) ) {
+      std::cout << "Waiting on staging batch submission failed." << std::endl;
+      return false;
+    }
+    return true;
+  }
+
+  void StagingRing::RetireCompletedBatches() {
+    while( !SubmittedBatches.empty() &&
+           Batches[SubmittedBatches.front()].Complete ) {
+      StagingBatch & batch = Batches[SubmittedBatches.front()];
+      // Empty batches leave Head untouched, so Tail never moves backwards
+      Tail = std::max( Tail, batch.End );
+      CompletedBatchId = batch.Id;
+      SubmittedBatches.pop_front();
+    }
+  }
+
+} // namespace VulkanCookbook
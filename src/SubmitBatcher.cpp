@@ -0,0 +1,269 @@
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Submit Batcher
+
+#include "SubmitBatcher.h"
+#include "VulkanPromoted.h"
+#include <algorithm>
+
+namespace VulkanCookbook {
+
+  namespace {
+
+    struct MergedBatch {
+      std::vector<VkSemaphore>            WaitSemaphores;
+      std::vector<uint64_t>               WaitValues;
+      std::vector<VkPipelineStageFlags>   WaitStages;
+      std::vector<VkCommandBuffer>        CommandBuffers;
+      std::vector<VkSemaphore>            SignalSemaphores;
+      std::vector<uint64_t>               SignalValues;
+      bool                                UsesTimelineValues;
+    };
+
+    void AddWaitSemaphore( MergedBatch             & merged_batch,
+                           SemaphoreWaitInfo const & wait ) {
+      auto semaphore = std::find( merged_batch.WaitSemaphores.begin(), merged_batch.WaitSemaphores.end(), wait.Semaphore );
+      if( semaphore != merged_batch.WaitSemaphores.end() ) {
+        size_t index = semaphore - merged_batch.WaitSemaphores.begin();
+        merged_batch.WaitValues[index] = std::max( merged_batch.WaitValues[index], wait.Value );
+        merged_batch.WaitStages[index] |= wait.WaitingStage;
+      } else {
+        merged_batch.WaitSemaphores.push_back( wait.Semaphore );
+        merged_batch.WaitValues.push_back( wait.Value );
+        merged_batch.WaitStages.push_back( wait.WaitingStage );
+      }
+      merged_batch.UsesTimelineValues |= (0 != wait.Value);
+    }
+
+    void AddSignalSemaphore( MergedBatch               & merged_batch,
+                             SemaphoreSignalInfo const & signal ) {
+      auto semaphore = std::find( merged_batch.SignalSemaphores.begin(), merged_batch.SignalSemaphores.end(), signal.Semaphore );
+      if( semaphore != merged_batch.SignalSemaphores.end() ) {
+        size_t index = semaphore - merged_batch.SignalSemaphores.begin();
+        merged_batch.SignalValues[index] = std::max( merged_batch.SignalValues[index], signal.Value );
+      } else {
+        merged_batch.SignalSemaphores.push_back( signal.Semaphore );
+        merged_batch.SignalValues.push_back( signal.Value );
+      }
+      merged_batch.UsesTimelineValues |= (0 != signal.Value);
+    }
+
+  } // namespace
+
+  bool SubmitBatchesToQueue( DeviceDispatch const           & dispatch,
+                             VkQueue                          queue,
+                             std::vector<SubmitBatch> const & batches,
+                             VkFence                          fence,
+                             uint32_t                       * submit_info_count ) {
+    std::vector<MergedBatch> merged_batches;
+    bool merged_batch_signals = false;
+    for( auto & batch : batches ) {
+      // Waits are moved before and signals after the other command buffers of a merged batch,
+      // which would make work wait longer than requested
+      if( merged_batches.empty() ||
+          merged_batch_signals ||
+          (!batch.WaitSemaphores.empty() && !merged_batches.back().CommandBuffers.empty()) ) {
+        merged_batches.emplace_back();
+        merged_batches.back().UsesTimelineValues = false;
+      }
+      MergedBatch & merged_batch = merged_batches.back();
+
+      for( auto & wait : batch.WaitSemaphores ) {
+        AddWaitSemaphore( merged_batch, wait );
+      }
+      merged_batch.CommandBuffers.insert( merged_batch.CommandBuffers.end(), batch.CommandBuffers.begin(), batch.CommandBuffers.end() );
+      for( auto & signal : batch.SignalSemaphores ) {
+        AddSignalSemaphore( merged_batch, signal );
+      }
+      merged_batch_signals = !batch.SignalSemaphores.empty();
+    }
+
+    std::vector<VkTimelineSemaphoreSubmitInfo> timeline_semaphore_submit_infos( merged_batches.size() );
+    std::vector<VkSubmitInfo> submit_infos( merged_batches.size() );
+    for( size_t i = 0; i < merged_batches.size(); ++i ) {
+      MergedBatch & merged_batch = merged_batches[i];
+
+      timeline_semaphore_submit_infos[i] = {
+        VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,               // VkStructureType    sType
+        nullptr,                                                        // const void       * pNext
+        static_cast<uint32_t>(merged_batch.WaitValues.size()),          // uint32_t           waitSemaphoreValueCount
+        merged_batch.WaitValues.data(),                                 // const uint64_t   * pWaitSemaphoreValues
+        static_cast<uint32_t>(merged_batch.SignalValues.size()),        // uint32_t           signalSemaphoreValueCount
+        merged_batch.SignalValues.data()                                // const uint64_t   * pSignalSemaphoreValues
+      };
+
+      // Devices without timeline semaphores do not accept the structure
+      void const * next = merged_batch.UsesTimelineValues ? &timeline_semaphore_submit_infos[i] : nullptr;
+
+      submit_infos[i] = {
+        VK_STRUCTURE_TYPE_SUBMIT_INFO,                                            // VkStructureType                sType
+        next,                                                                     // const void                   * pNext
+        static_cast<uint32_t>(merged_batch.WaitSemaphores.size()),                // uint32_t                       waitSemaphoreCount
+        merged_batch.WaitSemaphores.data(),                                       // const VkSemaphore            * pWaitSemaphores
+        merged_batch.WaitStages.data(),                                           // const VkPipelineStageFlags   * pWaitDstStageMask
+        static_cast<uint32_t>(merged_batch.CommandBuffers.size()),                // uint32_t                       commandBufferCount
+        merged_batch.CommandBuffers.data(),                                       // const VkCommandBuffer        * pCommandBuffers
+        static_cast<uint32_t>(merged_batch.SignalSemaphores.size()),              // uint32_t                       signalSemaphoreCount
+        merged_batch.SignalSemaphores.data()                                      // const VkSemaphore            * pSignalSemaphores
+      };
+    }
+
+    VkResult result = dispatch.vkQueueSubmit( queue, static_cast<uint32_t>(submit_infos.size()), submit_infos.data(), fence );
+    if( VK_SUCCESS != result ) {
+      std::cout << "Error occurred during command buffer submission." << std::endl;
+      return false;
+    }
+    if( nullptr != submit_info_count ) {
+      *submit_info_count = static_cast<uint32_t>(submit_infos.size());
+    }
+    return true;
+  }
+
+  SubmitBatcher::SubmitBatcher() :
+    Dispatch( nullptr ),
+    Statistics() {
+  }
+
+  bool SubmitBatcher::Initialize( DeviceDispatch const & dispatch ) {
+    Dispatch = &dispatch;
+    return true;
+  }
+
+  void SubmitBatcher::Add( VkQueue             queue,
+                           SubmitBatch const & batch,
+                           VkFence             fence ) {
+    std::lock_guard<std::mutex> lock( Mutex );
+    ++Statistics.Batches;
+
+    auto queue_batches = std::find_if( Queues.begin(), Queues.end(), [queue]( QueueBatches const & queue_batches ) {
+      return queue == queue_batches.Queue;
+    } );
+    if( queue_batches == Queues.end() ) {
+      Queues.push_back( { queue, {}, {} } );
+      queue_batches = Queues.end() - 1;
+    }
+    queue_batches->Batches.push_back( batch );
+    if( VK_NULL_HANDLE != fence ) {
+      queue_batches->Fences.push_back( fence );
+    }
+  }
+
+  bool SubmitBatcher::Flush( VkQueue                queue,
+                             VkFence                fence,
+                             bool                 * fence_submitted,
+                             std::vector<VkFence> * unsignaled_fences ) {
+    std::vector<SubmitBatch> batches;
+    std::vector<VkFence> fences;
+    {
+      std::lock_guard<std::mutex> lock( Mutex );
+      auto queue_batches = std::find_if( Queues.begin(), Queues.end(), [queue]( QueueBatches const & queue_batches ) {
+        return queue == queue_batches.Queue;
+      } );
+      if( queue_batches != Queues.end() ) {
+        batches.swap( queue_batches->Batches );
+        fences.swap( queue_batches->Fences );
+      }
+    }
+    if( nullptr != fence_submitted ) {
+      *fence_submitted = false;
+    }
+    if( batches.empty() &&
+        fences.empty() &&
+        (VK_NULL_HANDLE == fence) ) {
+      return true;
+    }
+
+    // The fence of the caller goes with the batches, so it is submitted exactly when they are
+    VkFence batches_fence = fence;
+    size_t first_empty_submit_fence = 0;
+    if( (VK_NULL_HANDLE == batches_fence) &&
+        !fences.empty() ) {
+      batches_fence = fences.front();
+      first_empty_submit_fence = 1;
+    }
+    uint32_t submit_info_count = 0;
+    bool batches_submitted = SubmitBatchesToQueue( *Dispatch, queue, batches, batches_fence, &submit_info_count );
+    if( !batches_submitted ) {
+      first_empty_submit_fence = 0;
+    }
+    if( nullptr != fence_submitted ) {
+      *fence_submitted = batches_submitted;
+    }
+
+    // Fence signal operations also wait for all the work submitted earlier to the queue
+    bool result = batches_submitted;
+    uint64_t fence_submits = 0;
+    for( size_t i = first_empty_submit_fence; i < fences.size(); ++i ) {
+      if( VK_SUCCESS != Dispatch->vkQueueSubmit( queue, 0, nullptr, fences[i] ) ) {
+        std::cout << "Could not submit a fence." << std::endl;
+        if( nullptr != unsignaled_fences ) {
+          unsignaled_fences->push_back( fences[i] );
+        }
+        result = false;
+        continue;
+      }
+      ++fence_submits;
+    }
+    std::lock_guard<std::mutex> lock( Mutex );
+    if( batches_submitted ) {
+      Statistics.SubmitInfos += submit_info_count;
+      ++Statistics.QueueSubmits;
+    }
+    Statistics.FenceSubmits += fence_submits;
+    return result;
+  }
+
+  bool SubmitBatcher::FlushAll( VkQueue                fence_queue,
+                                VkFence                fence,
+                                bool                 * fence_submitted,
+                                std::vector<VkFence> * unsignaled_fences ) {
+    std::vector<VkQueue> queues;
+    {
+      std::lock_guard<std::mutex> lock( Mutex );
+      for( auto & queue_batches : Queues ) {
+        queues.push_back( queue_batches.Queue );
+      }
+    }
+    if( (VK_NULL_HANDLE != fence_queue) &&
+        (std::find( queues.begin(), queues.end(), fence_queue ) == queues.end()) ) {
+      queues.push_back( fence_queue );
+    }
+
+    if( nullptr != fence_submitted ) {
+      *fence_submitted = false;
+    }
+    bool result = true;
+    for( auto queue : queues ) {
+      if( fence_queue == queue ) {
+        result &= Flush( queue, fence, fence_submitted, unsignaled_fences );
+      } else {
+        result &= Flush( queue, VK_NULL_HANDLE, nullptr, unsignaled_fences );
+      }
+    }
+    return result;
+  }
+
+  SubmitBatcherStatistics SubmitBatcher::GetStatistics() {
+    std::lock_guard<std::mutex> lock( Mutex );
+    return Statistics;
+  }
+
+} // namespace VulkanCookbook
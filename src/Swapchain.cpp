@@ -0,0 +1,271 @@
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Swapchain
+
+#include "Swapchain.h"
+#include "Resources.h"
+#include <algorithm>
+
+namespace VulkanCookbook {
+
+  bool SelectSizeOfSwapchainImages( VkSurfaceCapabilitiesKHR const & surface_capabilities,
+                                    VkExtent2D                     & size_of_images ) {
+    if( 0xFFFFFFFF == surface_capabilities.currentExtent.width ) {
+      size_of_images = { 640, 480 };
+
+      if( size_of_images.width < surface_capabilities.minImageExtent.width ) {
+        size_of_images.width = surface_capabilities.minImageExtent.width;
+      } else if( size_of_images.width > surface_capabilities.maxImageExtent.width ) {
+        size_of_images.width = surface_capabilities.maxImageExtent.width;
+      }
+
+      if( size_of_images.height < surface_capabilities.minImageExtent.height ) {
+        size_of_images.height = surface_capabilities.minImageExtent.height;
+      } else if( size_of_images.height > surface_capabilities.maxImageExtent.height ) {
+        size_of_images.height = surface_capabilities.maxImageExtent.height;
+      }
+    } else {
+      size_of_images = surface_capabilities.currentExtent;
+    }
+    return true;
+  }
+
+  bool SelectDesiredUsageScenariosOfSwapchainImages( VkSurfaceCapabilitiesKHR const & surface_capabilities,
+                                                     VkImageUsageFlags                desired_usages,
+                                                     VkImageUsageFlags              & image_usage ) {
+    image_usage = desired_usages & surface_capabilities.supportedUsageFlags;
+
+    return desired_usages == image_usage;
+  }
+
+  bool SelectTransformationOfSwapchainImages( VkSurfaceCapabilitiesKHR const & surface_capabilities,
+                                              VkSurfaceTransformFlagBitsKHR    desired_transform,
+                                              VkSurfaceTransformFlagBitsKHR  & surface_transform ) {
+    if( surface_capabilities.supportedTransforms & desired_transform ) {
+      surface_transform = desired_transform;
+    } else {
+      surface_transform = surface_capabilities.currentTransform;
+    }
+    return true;
+  }
+
+  bool SelectFormatOfSwapchainImages( VkPhysicalDevice     physical_device,
+                                      VkSurfaceKHR         presentation_surface,
+                                      VkSurfaceFormatKHR   desired_surface_format,
+                                      VkFormat           & image_format,
+                                      VkColorSpaceKHR    & image_color_space ) {
+    // Enumerate supported formats
+    uint32_t formats_count = 0;
+    VkResult result = VK_SUCCESS;
+
+    result = vkGetPhysicalDeviceSurfaceFormatsKHR( physical_device, presentation_surface, &formats_count, nullptr );
+    if( (VK_SUCCESS != result) ||
+        (0 == formats_count) ) {
+      std::cout << "Could not get the number of supported surface formats." << std::endl;
+      return false;
+    }
+
+    std::vector<VkSurfaceFormatKHR> surface_formats( formats_count );
+    result = vkGetPhysicalDeviceSurfaceFormatsKHR( physical_device, presentation_surface, &formats_count, surface_formats.data() );
+    if( (VK_SUCCESS != result) ||
+        (0 == formats_count) ) {
+      std::cout << "Could not enumerate supported surface formats." << std::endl;
+      return false;
+    }
+
+    // Select surface format
+    if( (1 == surface_formats.size()) &&
+        (VK_FORMAT_UNDEFINED == surface_formats[0].format) ) {
+      image_format = desired_surface_format.format;
+      image_color_space = desired_surface_format.colorSpace;
+      return true;
+    }
+
+    for( auto & surface_format : surface_formats ) {
+      if( (desired_surface_format.format == surface_format.format) &&
+          (desired_surface_format.colorSpace == surface_format.colorSpace) ) {
+        image_format = desired_surface_format.format;
+        image_color_space = desired_surface_format.colorSpace;
+        return true;
+      }
+    }
+
+    for( auto & surface_format : surface_formats ) {
+      if( (desired_surface_format.format == surface_format.format) ) {
+        image_format = desired_surface_format.format;
+        image_color_space = surface_format.colorSpace;
+        std::cout << "Desired combination of format and colorspace is not supported. Selecting other colorspace." << std::endl;
+        return true;
+      }
+    }
+
+    image_format = surface_formats[0].format;
+    image_color_space = surface_formats[0].colorSpace;
+    std::cout << "Desired format is not supported. Selecting available format - colorspace combination." << std::endl;
+    return true;
+  }
+
+  bool CreateSwapchain( DeviceDispatch const          & dispatch,
+                        VkSurfaceKHR                    presentation_surface,
+                        uint32_t                        image_count,
+                        VkSurfaceFormatKHR              surface_format,
+                        VkExtent2D                      image_size,
+                        VkImageUsageFlags               image_usage,
+                        VkSurfaceTransformFlagBitsKHR   surface_transform,
+                        VkPresentModeKHR                present_mode,
+                        VkSwapchainKHR                  old_swapchain,
+                        std::vector<uint32_t> const   & queue_families,
+                        VkSwapchainKHR                & swapchain ) {
+    std::vector<uint32_t> unique_queue_families;
+    for( auto queue_family : queue_families ) {
+      if( std::find( unique_queue_families.begin(), unique_queue_families.end(), queue_family ) == unique_queue_families.end() ) {
+        unique_queue_families.push_back( queue_family );
+      }
+    }
+    bool concurrent = unique_queue_families.size() > 1;
+    VkSharingMode sharing_mode = concurrent ? VK_SHARING_MODE_CONCURRENT : VK_SHARING_MODE_EXCLUSIVE;
+    uint32_t queue_family_count = concurrent ? static_cast<uint32_t>(unique_queue_families.size()) : 0;
+
+    VkSwapchainCreateInfoKHR swapchain_create_info = {
+      VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR,  // VkStructureType                  sType
+      nullptr,                                      // const void                     * pNext
+      0,                                            // VkSwapchainCreateFlagsKHR        flags
+      presentation_surface,                         // VkSurfaceKHR                     surface
+      image_count,                                  // uint32_t                         minImageCount
+      surface_format.format,                        // VkFormat                         imageFormat
+      surface_format.colorSpace,                    // VkColorSpaceKHR                  imageColorSpace
+      image_size,                                   // VkExtent2D                       imageExtent
+      1,                                            // uint32_t                         imageArrayLayers
+      image_usage,                                  // VkImageUsageFlags                imageUsage
+      sharing_mode,                                 // VkSharingMode                    imageSharingMode
+      queue_family_count,                           // uint32_t                         queueFamilyIndexCount
+      unique_queue_families.data(),                 // const uint32_t                 * pQueueFamilyIndices
+      surface_transform,                            // VkSurfaceTransformFlagBitsKHR    preTransform
+      VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR,            // VkCompositeAlphaFlagBitsKHR      compositeAlpha
+      present_mode,                                 // VkPresentModeKHR                 presentMode
+      VK_TRUE,                                      // VkBool32                         clipped
+      old_swapchain                                 // VkSwapchainKHR                   oldSwapchain
+    };
+
+    VkResult result = dispatch.vkCreateSwapchainKHR( dispatch.Device, &swapchain_create_info, nullptr, &swapchain );
+    if( (VK_SUCCESS != result) ||
+        (VK_NULL_HANDLE == swapchain) ) {
+      std::cout << "Could not create a swapchain." << std::endl;
+      return false;
+    }
+    return true;
+  }
+
+  bool GetHandlesOfSwapchainImages( DeviceDispatch const & dispatch,
+                                    VkSwapchainKHR         swapchain,
+                                    std::vector<VkImage> & swapchain_images ) {
+    uint32_t images_count = 0;
+    VkResult result = VK_SUCCESS;
+
+    result = dispatch.vkGetSwapchainImagesKHR( dispatch.Device, swapchain, &images_count, nullptr );
+    if( (VK_SUCCESS != result) ||
+        (0 == images_count) ) {
+      std::cout << "Could not get the number of swapchain images." << std::endl;
+      return false;
+    }
+
+    swapchain_images.resize( images_count );
+    result = dispatch.vkGetSwapchainImagesKHR( dispatch.Device, swapchain, &images_count, swapchain_images.data() );
+    if( (VK_SUCCESS != result) ||
+        (0 == images_count) ) {
+      std::cout << "Could not enumerate swapchain images." << std::endl;
+      return false;
+    }
+    return true;
+  }
+
+  bool CreateSwapchainWithImageViews( VkPhysicalDevice                physical_device,
+                                      DeviceDispatch const          & dispatch,
+                                      VkSurfaceKHR                    presentation_surface,
+                                      uint32_t                        image_count,
+                                      VkPresentModeKHR                present_mode,
+                                      VkImageUsageFlags               image_usage,
+                                      VkSwapchainKHR                  old_swapchain,
+                                      std::vector<uint32_t> const   & queue_families,
+                                      SwapchainState                & swapchain ) {
+    VkSurfaceCapabilitiesKHR surface_capabilities;
+    VkResult result = vkGetPhysicalDeviceSurfaceCapabilitiesKHR( physical_device, presentation_surface, &surface_capabilities );
+    if( VK_SUCCESS != result ) {
+      std::cout << "Could not get the capabilities of a presentation surface." << std::endl;
+      return false;
+    }
+
+    VkExtent2D image_size;
+    if( !SelectSizeOfSwapchainImages( surface_capabilities, image_size ) ) {
+      return false;
+    }
+    // A minimized window has no area to present to
+    if( (0 == image_size.width) ||
+        (0 == image_size.height) ) {
+      return false;
+    }
+
+    VkImageUsageFlags supported_image_usage;
+    if( !SelectDesiredUsageScenariosOfSwapchainImages( surface_capabilities, image_usage, supported_image_usage ) ) {
+      std::cout << "Desired swapchain image usage is not supported." << std::endl;
+      return false;
+    }
+
+    VkSurfaceTransformFlagBitsKHR surface_transform;
+    SelectTransformationOfSwapchainImages( surface_capabilities, VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR, surface_transform );
+
+    VkSurfaceFormatKHR surface_format;
+    if( !SelectFormatOfSwapchainImages( physical_device, presentation_surface, { VK_FORMAT_B8G8R8A8_UNORM, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR }, surface_format.format, surface_format.colorSpace ) ) {
+      return false;
+    }
+
+    SwapchainState new_swapchain;
+    InitVkDestroyer( dispatch, new_swapchain.Handle );
+    if( !CreateSwapchain( dispatch, presentation_surface, image_count, surface_format, image_size, supported_image_usage, surface_transform, present_mode, old_swapchain, queue_families, *new_swapchain.Handle ) ) {
+      return false;
+    }
+    new_swapchain.Format = surface_format.format;
+    new_swapchain.Size = image_size;
+
+    if( !GetHandlesOfSwapchainImages( dispatch, *new_swapchain.Handle, new_swapchain.Images ) ) {
+      return false;
+    }
+
+    for( auto & image : new_swapchain.Images ) {
+      new_swapchain.ImageViews.emplace_back();
+      InitVkDestroyer( dispatch, new_swapchain.ImageViews.back() );
+      if( !CreateImageView( dispatch, image, VK_IMAGE_VIEW_TYPE_2D, surface_format.format, VK_IMAGE_ASPECT_COLOR_BIT, *new_swapchain.ImageViews.back() ) ) {
+        return false;
+      }
+    }
+
+    swapchain = std::move( new_swapchain );
+    return true;
+  }
+
+  void DestroySwapchain( SwapchainState & swapchain ) {
+    // Views must go before the images they reference, which are owned by the swapchain
+    swapchain.ImageViews.clear();
+    swapchain.Images.clear();
+    swapchain.Handle = VkDestroyer(VkSwapchainKHR)();
+  }
+
+} // namespace VulkanCookbook
@@ -0,0 +1,550 @@
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Texture Streamer
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+#include "TextureStreamer.h"
+#include "Resources.h"
+#include "Tools.h"
+#include <algorithm>
+
+namespace VulkanCookbook {
+
+  namespace {
+
+    VkFormat const TextureFormat = VK_FORMAT_R8G8B8A8_UNORM;
+
+    // 2x2 box filter; the last row or column of odd sized levels is reused
+    void GenerateMipmapChain( std::vector<MipmapLevel> & levels ) {
+      while( (levels.back().Width > 1) ||
+             (levels.back().Height > 1) ) {
+        MipmapLevel const & source = levels.back();
+        MipmapLevel level = {
+          std::max( source.Width / 2, 1u ),
+          std::max( source.Height / 2, 1u ),
+          {}
+        };
+        level.Data.resize( 4 * static_cast<size_t>(level.Width) * level.Height );
+
+        for( uint32_t y = 0; y < level.Height; ++y ) {
+          unsigned char const * row0 = &source.Data[4 * static_cast<size_t>(source.Width) * std::min( 2 * y, source.Height - 1 )];
+          unsigned char const * row1 = &source.Data[4 * static_cast<size_t>(source.Width) * std::min( 2 * y + 1, source.Height - 1 )];
+          unsigned char * destination = &level.Data[4 * static_cast<size_t>(level.Width) * y];
+
+          for( uint32_t x = 0; x < level.Width; ++x ) {
+            uint32_t x0 = 4 * std::min( 2 * x, source.Width - 1 );
+            uint32_t x1 = 4 * std::min( 2 * x + 1, source.Width - 1 );
+            for( uint32_t c = 0; c < 4; ++c ) {
+              destination[4 * x + c] = static_cast<unsigned char>((row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c] + 2) / 4);
+            }
+          }
+        }
+        levels.push_back( std::move( level ) );
+      }
+    }
+
+    // Runs on worker threads, so it must not touch the streamer
+    std::vector<MipmapLevel> DecodeTexture( std::string const & filename ) {
+      std::vector<MipmapLevel> levels;
+
+      MappedFile file;
+      ByteSpan file_contents;
+      if( !GetBinaryFileContents( filename, file, file_contents, MAPPED_FILE_HINT_SEQUENTIAL_BIT | MAPPED_FILE_HINT_POPULATE_BIT ) ) {
+        return levels;
+      }
+
+      int width = 0;
+      int height = 0;
+      int components = 0;
+      stbi_uc * pixels = stbi_load_from_memory( file_contents.Data, static_cast<int>(file_contents.Size), &width, &height, &components, 4 );
+      if( nullptr == pixels ) {
+        std::cout << "Could not decode '" << filename << "' texture: " << stbi_failure_reason() << std::endl;
+        return levels;
+      }
+
+      levels.push_back( {
+        static_cast<uint32_t>(width),
+        static_cast<uint32_t>(height),
+        std::vector<unsigned char>( pixels, pixels + 4 * static_cast<size_t>(width) * height )
+      } );
+      stbi_image_free( pixels );
+
+      GenerateMipmapChain( levels );
+      return levels;
+    }
+
+  } // namespace
+
+  TextureStreamer::TextureStreamer() :
+    Dispatch( nullptr ),
+    Allocator( nullptr ),
+    Ring( nullptr ),
+    StagingQueueFamily( VK_QUEUE_FAMILY_IGNORED ),
+    ConsumerQueueFamily( VK_QUEUE_FAMILY_IGNORED ),
+    Budget( 0 ),
+    RetireDelay( 0 ),
+    MaxPendingDecodes( 0 ),
+    UploadBytesPerUpdate( 0 ),
+    UsedBytes( 0 ),
+    NextRequestSerial( 0 ),
+    CurrentFrame( 0 ),
+    EvictionCount( 0 ) {
+  }
+
+  TextureStreamer::~TextureStreamer() {
+    Destroy();
+  }
+
+  bool TextureStreamer::Initialize( DeviceDispatch const  & dispatch,
+                                    DeviceMemoryAllocator & allocator,
+                                    StagingRing           & staging_ring,
+                                    uint32_t                staging_queue_family,
+                                    uint32_t                consumer_queue_family,
+                                    uint32_t                thread_count,
+                                    VkDeviceSize            budget,
+                                    uint32_t                retire_delay ) {
+    Destroy();
+
+    Dispatch = &dispatch;
+    Allocator = &allocator;
+    Ring = &staging_ring;
+    StagingQueueFamily = staging_queue_family;
+    ConsumerQueueFamily = consumer_queue_family;
+    Budget = budget;
+    RetireDelay = std::max( retire_delay, 1u );
+    Workers.reset( new ThreadPool( thread_count ) );
+    // Decoded mip chains wait in system memory, so only a few are allowed at once
+    MaxPendingDecodes = 2 * Workers->GetThreadCount();
+    // Leave half of the ring for other users and for the batches still in flight
+    UploadBytesPerUpdate = Ring->GetSize() / 2;
+    UsedBytes = 0;
+    NextRequestSerial = 0;
+    CurrentFrame = 0;
+    EvictionCount = 0;
+    return true;
+  }
+
+  void TextureStreamer::Destroy() {
+    if( nullptr == Dispatch ) {
+      return;
+    }
+    Workers.reset();
+
+    // Recorded copies reference the images
+    Ring->Flush();
+    Ring->WaitIdle();
+
+    DecodeQueue = std::priority_queue<PendingDecode>();
+    DecodingTextures.clear();
+    DecodedTextures.clear();
+    UploadingTextures.clear();
+    PendingAcquires.clear();
+    Textures.clear();
+    RetiredImages.clear();
+    UsedBytes = 0;
+    Ring = nullptr;
+    Allocator = nullptr;
+    Dispatch = nullptr;
+  }
+
+  TextureHandle TextureStreamer::RegisterTexture( std::string const & filename ) {
+    Textures.emplace_back();
+    StreamedTexture & texture = Textures.back();
+    texture.Filename = filename;
+    texture.State = TextureStreamState::Idle;
+    texture.RequestedMip = UINT32_MAX;
+    texture.FinestMip = 0;
+    texture.RequestSerial = 0;
+    texture.LastRequestedFrame = 0;
+    texture.UploadBatchId = 0;
+    return static_cast<TextureHandle>(Textures.size() - 1);
+  }
+
+  void TextureStreamer::RequestTexture( TextureHandle handle,
+                                        uint32_t      mip_level ) {
+    StreamedTexture & texture = Textures[handle];
+    texture.LastRequestedFrame = CurrentFrame;
+    mip_level = std::max( mip_level, texture.FinestMip );
+
+    switch( texture.State ) {
+    case TextureStreamState::Idle:
+      if( !texture.Resident.Image ||
+          (mip_level < texture.Resident.BaseMip) ) {
+        texture.RequestedMip = mip_level;
+        QueueDecode( handle );
+      }
+      break;
+    case TextureStreamState::Queued:
+      // Re-queue with the higher priority, the old entry is skipped as stale
+      if( mip_level < texture.RequestedMip ) {
+        texture.RequestedMip = mip_level;
+        QueueDecode( handle );
+      }
+      break;
+    case TextureStreamState::Decoding:
+    case TextureStreamState::Decoded:
+    case TextureStreamState::Uploading:
+      texture.RequestedMip = std::min( texture.RequestedMip, mip_level );
+      break;
+    case TextureStreamState::Failed:
+      break;
+    }
+  }
+
+  VkImageView TextureStreamer::GetTextureView( TextureHandle   handle,
+                                               uint32_t      * base_mip ) const {
+    if( handle >= Textures.size() ) {
+      return VK_NULL_HANDLE;
+    }
+    TextureImage const & resident = Textures[handle].Resident;
+    if( (nullptr != base_mip) &&
+        resident.View ) {
+      *base_mip = resident.BaseMip;
+    }
+    return *resident.View;
+  }
+
+  TextureStreamState TextureStreamer::GetTextureState( TextureHandle handle ) const {
+    return Textures[handle].State;
+  }
+
+  bool TextureStreamer::Update() {
+    if( nullptr == Dispatch ) {
+      return false;
+    }
+
+    CollectUploadedTextures();
+    ReleaseRetiredImages();
+    CollectDecodedTextures();
+    DispatchDecodes();
+    bool result = UploadDecodedTextures();
+    if( !Ring->Flush() ) {
+      result = false;
+    }
+
+    ++CurrentFrame;
+    return result;
+  }
+
+  void TextureStreamer::RecordAcquireBarriers( VkCommandBuffer command_buffer ) {
+    if( PendingAcquires.empty() ) {
+      return;
+    }
+
+    // Must match the per-level release barriers recorded by StagingRing::UploadToImage()
+    std::vector<VkImageMemoryBarrier> image_memory_barriers;
+    for( auto & acquire : PendingAcquires ) {
+      for( uint32_t level = 0; level < acquire.MipCount; ++level ) {
+        image_memory_barriers.push_back( {
+          VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,     // VkStructureType            sType
+          nullptr,                                    // const void               * pNext
+          0,                                          // VkAccessFlags              srcAccessMask
+          VK_ACCESS_SHADER_READ_BIT,                  // VkAccessFlags              dstAccessMask
+          VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,       // VkImageLayout              oldLayout
+          VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,   // VkImageLayout              newLayout
+          StagingQueueFamily,                         // uint32_t                   srcQueueFamilyIndex
+          ConsumerQueueFamily,                        // uint32_t                   dstQueueFamilyIndex
+          acquire.Image,                              // VkImage                    image
+          {                                           // VkImageSubresourceRange    subresourceRange
+            VK_IMAGE_ASPECT_COLOR_BIT,                  // VkImageAspectFlags         aspectMask
+            level,                                      // uint32_t                   baseMipLevel
+            1,                                          // uint32_t                   levelCount
+            0,                                          // uint32_t                   baseArrayLayer
+            1                                           // uint32_t                   layerCount
+          }
+        } );
+      }
+    }
+    Dispatch->vkCmdPipelineBarrier( command_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                          0, 0, nullptr, 0, nullptr, static_cast<uint32_t>(image_memory_barriers.size()), image_memory_barriers.data() );
+    PendingAcquires.clear();
+  }
+
+  TextureStreamerStatistics TextureStreamer::GetStatistics() const {
+    TextureStreamerStatistics statistics = {};
+    statistics.TextureCount = static_cast<uint32_t>(Textures.size());
+    statistics.ResidentBytes = UsedBytes;
+    statistics.Budget = Budget;
+    statistics.EvictionCount = EvictionCount;
+    for( auto & texture : Textures ) {
+      if( texture.Resident.Image ) {
+        ++statistics.ResidentCount;
+      }
+      if( (TextureStreamState::Idle != texture.State) &&
+          (TextureStreamState::Failed != texture.State) ) {
+        ++statistics.PendingCount;
+      }
+    }
+    return statistics;
+  }
+
+  bool TextureStreamer::IsRecentlyRequested( StreamedTexture const & texture ) const {
+    return texture.LastRequestedFrame + RetireDelay > CurrentFrame;
+  }
+
+  void TextureStreamer::QueueDecode( TextureHandle handle ) {
+    StreamedTexture & texture = Textures[handle];
+    texture.State = TextureStreamState::Queued;
+    texture.RequestSerial = NextRequestSerial++;
+    DecodeQueue.push( { texture.RequestedMip, texture.RequestSerial, handle } );
+  }
+
+  void TextureStreamer::CollectUploadedTextures() {
+    std::vector<TextureHandle> still_uploading;
+    for( auto handle : UploadingTextures ) {
+      StreamedTexture & texture = Textures[handle];
+      if( !Ring->IsBatchComplete( texture.UploadBatchId ) ) {
+        still_uploading.push_back( handle );
+        continue;
+      }
+
+      // The previous image may still be sampled by frames in flight
+      RetireImage( texture.Resident );
+      texture.Resident = std::move( texture.Uploading );
+      if( (VK_QUEUE_FAMILY_IGNORED != ConsumerQueueFamily) &&
+          (StagingQueueFamily != ConsumerQueueFamily) ) {
+        PendingAcquires.push_back( { *texture.Resident.Image, texture.Resident.MipCount } );
+      }
+      texture.State = TextureStreamState::Idle;
+
+      // More detail could have been requested during the upload
+      if( (texture.RequestedMip < texture.Resident.BaseMip) &&
+          IsRecentlyRequested( texture ) ) {
+        QueueDecode( handle );
+      }
+    }
+    UploadingTextures.swap( still_uploading );
+  }
+
+  void TextureStreamer::CollectDecodedTextures() {
+    std::vector<TextureHandle> still_decoding;
+    for( auto handle : DecodingTextures ) {
+      StreamedTexture & texture = Textures[handle];
+      if( std::future_status::ready != texture.Decoding.wait_for( std::chrono::seconds( 0 ) ) ) {
+        still_decoding.push_back( handle );
+        continue;
+      }
+
+      texture.Levels = texture.Decoding.get();
+      if( texture.Levels.empty() ) {
+        texture.State = TextureStreamState::Failed;
+      } else {
+        texture.State = TextureStreamState::Decoded;
+        DecodedTextures.push_back( handle );
+      }
+    }
+    DecodingTextures.swap( still_decoding );
+  }
+
+  void TextureStreamer::DispatchDecodes() {
+    while( (DecodingTextures.size() + DecodedTextures.size() < MaxPendingDecodes) &&
+           !DecodeQueue.empty() ) {
+      PendingDecode pending = DecodeQueue.top();
+      DecodeQueue.pop();
+
+      StreamedTexture & texture = Textures[pending.Handle];
+      if( (TextureStreamState::Queued != texture.State) ||
+          (pending.Serial != texture.RequestSerial) ) {
+        continue;
+      }
+      if( !IsRecentlyRequested( texture ) ) {
+        texture.State = TextureStreamState::Idle;
+        continue;
+      }
+
+      std::string filename = texture.Filename;
+      texture.Decoding = Workers->Submit( [filename]( uint32_t ) {
+        return DecodeTexture( filename );
+      } );
+      texture.State = TextureStreamState::Decoding;
+      DecodingTextures.push_back( pending.Handle );
+    }
+  }
+
+  bool TextureStreamer::UploadDecodedTextures() {
+    std::stable_sort( DecodedTextures.begin(), DecodedTextures.end(), [this]( TextureHandle left, TextureHandle right ) {
+      return Textures[left].RequestedMip < Textures[right].RequestedMip;
+    } );
+
+    bool result = true;
+    VkDeviceSize recorded_bytes = 0;
+    std::vector<TextureHandle> still_decoded;
+    for( auto handle : DecodedTextures ) {
+      StreamedTexture & texture = Textures[handle];
+      if( !IsRecentlyRequested( texture ) ) {
+        std::vector<MipmapLevel>().swap( texture.Levels );
+        texture.State = TextureStreamState::Idle;
+        continue;
+      }
+      if( recorded_bytes >= UploadBytesPerUpdate ) {
+        still_decoded.push_back( handle );
+        continue;
+      }
+
+      // The most detailed levels which cannot be staged at once or do not fit
+      // into the budget are never streamed
+      uint32_t level_count = static_cast<uint32_t>(texture.Levels.size());
+      VkDeviceSize bytes = 0;
+      for( auto & level : texture.Levels ) {
+        bytes += level.Data.size();
+      }
+      texture.FinestMip = 0;
+      while( (texture.FinestMip + 1 < level_count) &&
+             ((texture.Levels[texture.FinestMip].Data.size() > Ring->GetSize()) ||
+              (bytes > Budget)) ) {
+        bytes -= texture.Levels[texture.FinestMip].Data.size();
+        ++texture.FinestMip;
+      }
+      texture.RequestedMip = std::max( texture.RequestedMip, texture.FinestMip );
+
+      uint32_t base_mip = std::min( texture.RequestedMip, level_count - 1 );
+      for( uint32_t level = texture.FinestMip; level < base_mip; ++level ) {
+        bytes -= texture.Levels[level].Data.size();
+      }
+      if( texture.Resident.Image &&
+          (base_mip >= texture.Resident.BaseMip) ) {
+        std::vector<MipmapLevel>().swap( texture.Levels );
+        texture.State = TextureStreamState::Idle;
+        continue;
+      }
+
+      if( !MakeRoom( bytes ) ) {
+        still_decoded.push_back( handle );
+        continue;
+      }
+      if( !UploadTexture( texture, base_mip ) ) {
+        std::vector<MipmapLevel>().swap( texture.Levels );
+        texture.State = TextureStreamState::Failed;
+        result = false;
+        continue;
+      }
+      std::vector<MipmapLevel>().swap( texture.Levels );
+      texture.State = TextureStreamState::Uploading;
+      UploadingTextures.push_back( handle );
+      recorded_bytes += bytes;
+    }
+    DecodedTextures.swap( still_decoded );
+    return result;
+  }
+
+  bool TextureStreamer::UploadTexture( StreamedTexture & texture,
+                                       uint32_t          base_mip ) {
+    TextureImage & image = texture.Uploading;
+    MipmapLevel const & base_level = texture.Levels[base_mip];
+    image.BaseMip = base_mip;
+    image.MipCount = static_cast<uint32_t>(texture.Levels.size()) - base_mip;
+    image.Bytes = 0;
+
+    InitVkDestroyer( *Dispatch, image.Image );
+    if( !CreateImage( *Dispatch, VK_IMAGE_TYPE_2D, TextureFormat, { base_level.Width, base_level.Height, 1 }, image.MipCount, 1, VK_SAMPLE_COUNT_1_BIT,
+                      VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT, false, *image.Image ) ) {
+      image = TextureImage();
+      return false;
+    }
+    if( !AllocateAndBindMemoryObjectToImage( *Allocator, *image.Image, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, VK_IMAGE_TILING_OPTIMAL, image.Memory ) ) {
+      image = TextureImage();
+      return false;
+    }
+    image.Bytes = (*image.Memory)->Size;
+    UsedBytes += image.Bytes;
+
+    InitVkDestroyer( *Dispatch, image.View );
+    if( !CreateImageView( *Dispatch, *image.Image, VK_IMAGE_VIEW_TYPE_2D, TextureFormat, VK_IMAGE_ASPECT_COLOR_BIT, *image.View ) ) {
+      UsedBytes -= image.Bytes;
+      image = TextureImage();
+      return false;
+    }
+
+    for( uint32_t level = 0; level < image.MipCount; ++level ) {
+      MipmapLevel const & mipmap = texture.Levels[base_mip + level];
+      if( !Ring->UploadToImage( mipmap.Data.data(), mipmap.Data.size(), *image.Image,
+                                { VK_IMAGE_ASPECT_COLOR_BIT, level, 0, 1 }, { 0, 0, 0 }, { mipmap.Width, mipmap.Height, 1 },
+                                VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, ConsumerQueueFamily ) ) {
+        // Copies of the previous levels may already be recorded
+        Ring->Flush();
+        Ring->WaitIdle();
+        UsedBytes -= image.Bytes;
+        image = TextureImage();
+        return false;
+      }
+    }
+    // Batches complete in order, so the last one covers every level
+    texture.UploadBatchId = Ring->GetRecordingBatchId();
+    return true;
+  }
+
+  bool TextureStreamer::MakeRoom( VkDeviceSize bytes ) {
+    if( UsedBytes + bytes <= Budget ) {
+      return true;
+    }
+
+    // Least recently requested first; textures used by recent frames stay
+    std::vector<TextureHandle> candidates;
+    for( TextureHandle handle = 0; handle < Textures.size(); ++handle ) {
+      StreamedTexture & texture = Textures[handle];
+      if( texture.Resident.Image &&
+          !IsRecentlyRequested( texture ) ) {
+        candidates.push_back( handle );
+      }
+    }
+    std::sort( candidates.begin(), candidates.end(), [this]( TextureHandle left, TextureHandle right ) {
+      return Textures[left].LastRequestedFrame < Textures[right].LastRequestedFrame;
+    } );
+
+    for( auto handle : candidates ) {
+      if( UsedBytes + bytes <= Budget ) {
+        break;
+      }
+      TextureImage & resident = Textures[handle].Resident;
+      RemovePendingAcquire( *resident.Image );
+      UsedBytes -= resident.Bytes;
+      resident = TextureImage();
+      ++EvictionCount;
+    }
+    return UsedBytes + bytes <= Budget;
+  }
+
+  void TextureStreamer::RetireImage( TextureImage & image ) {
+    if( !image.Image ) {
+      return;
+    }
+    RemovePendingAcquire( *image.Image );
+    RetiredImages.push_back( { std::move( image ), CurrentFrame } );
+  }
+
+  void TextureStreamer::RemovePendingAcquire( VkImage image ) {
+    PendingAcquires.erase( std::remove_if( PendingAcquires.begin(), PendingAcquires.end(), [image]( PendingAcquire const & acquire ) {
+      return acquire.Image == image;
+    } ), PendingAcquires.end() );
+  }
+
+  void TextureStreamer::ReleaseRetiredImages() {
+    auto first_kept = std::stable_partition( RetiredImages.begin(), RetiredImages.end(), [this]( RetiredImage const & retired ) {
+      return retired.Frame + RetireDelay <= CurrentFrame;
+    } );
+    for( auto retired = RetiredImages.begin(); retired != first_kept; ++retired ) {
+      UsedBytes -= retired->Image.Bytes;
+    }
+    RetiredImages.erase( RetiredImages.begin(), first_kept );
+  }
+
+} // namespace VulkanCookbook
@@ -0,0 +1,86 @@
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Thread Pool
+
+#include <algorithm>
+#include "ThreadPool.h"
+
+namespace VulkanCookbook {
+
+  ThreadPool::ThreadPool( uint32_t thread_count ) :
+    ActiveTaskCount( 0 ),
+    Stopping( false ) {
+    if( 0 == thread_count ) {
+      thread_count = std::max( 1u, std::thread::hardware_concurrency() );
+    }
+    for( uint32_t index = 0; index < thread_count; ++index ) {
+      Workers.emplace_back( &ThreadPool::WorkerLoop, this, index );
+    }
+  }
+
+  ThreadPool::~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock( Mutex );
+      Stopping = true;
+    }
+    TaskAvailable.notify_all();
+    for( auto & worker : Workers ) {
+      worker.join();
+    }
+  }
+
+  void ThreadPool::WaitIdle() {
+    std::unique_lock<std::mutex> lock( Mutex );
+    TasksFinished.wait( lock, [this]() {
+      return Tasks.empty() && (0 == ActiveTaskCount);
+    } );
+  }
+
+  void ThreadPool::WorkerLoop( uint32_t worker_index ) {
+    for( ;; ) {
+      std::function<void( uint32_t )> task;
+      {
+        std::unique_lock<std::mutex> lock( Mutex );
+        TaskAvailable.wait( lock, [this]() {
+          return Stopping || !Tasks.empty();
+        } );
+        // Pending tasks are still drained on shutdown, their futures must become ready
+        if( Tasks.empty() ) {
+          return;
+        }
+        task = std::move( Tasks.front() );
+        Tasks.pop_front();
+        ++ActiveTaskCount;
+      }
+
+      task( worker_index );
+
+      {
+        std::lock_guard<std::mutex> lock( Mutex );
+        --ActiveTaskCount;
+        if( Tasks.empty() && (0 == ActiveTaskCount) ) {
+          TasksFinished.notify_all();
+        }
+      }
+    }
+  }
+
+} // namespace VulkanCookbook
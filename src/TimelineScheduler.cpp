@@ -0,0 +1,293 @@
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Timeline Scheduler
+
+#include "TimelineScheduler.h"
+#include "ExtensionTable.h"
+#include <algorithm>
+
+namespace VulkanCookbook {
+
+  bool PrepareTimelineSemaphoreFeatures( VkPhysicalDevice                            physical_device,
+                                         std::vector<char const *>                 & desired_extensions,
+                                         VkPhysicalDeviceTimelineSemaphoreFeatures & timeline_semaphore_features ) {
+    timeline_semaphore_features = {
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES,  // VkStructureType    sType
+      nullptr,                                                        // void             * pNext
+      VK_TRUE                                                         // VkBool32           timelineSemaphore
+    };
+
+    // Every Vulkan 1.2 device supports timeline semaphores
+    if( GetNegotiatedApiVersion( physical_device ) >= VK_API_VERSION_1_2 ) {
+      return true;
+    }
+
+    uint32_t extensions_count = 0;
+    vkEnumerateDeviceExtensionProperties( physical_device, nullptr, &extensions_count, nullptr );
+    std::vector<VkExtensionProperties> available_extensions( extensions_count );
+    vkEnumerateDeviceExtensionProperties( physical_device, nullptr, &extensions_count, available_extensions.data() );
+
+    if( !ExtensionTable( available_extensions ).Contains( VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME ) ) {
+      timeline_semaphore_features.timelineSemaphore = VK_FALSE;
+      return false;
+    }
+    if( std::none_of( desired_extensions.begin(), desired_extensions.end(), []( char const * extension ) {
+      return 0 == strcmp( extension, VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME );
+    } ) ) {
+      desired_extensions.push_back( VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME );
+    }
+    return true;
+  }
+
+  bool CreateTimelineSemaphore( DeviceDispatch const & dispatch,
+                                uint64_t               initial_value,
+                                VkSemaphore          & semaphore ) {
+    VkSemaphoreTypeCreateInfo semaphore_type_create_info = {
+      VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,   // VkStructureType    sType
+      nullptr,                                        // const void       * pNext
+      VK_SEMAPHORE_TYPE_TIMELINE,                     // VkSemaphoreType    semaphoreType
+      initial_value                                   // uint64_t           initialValue
+    };
+
+    VkSemaphoreCreateInfo semaphore_create_info = {
+      VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,    // VkStructureType            sType
+      &semaphore_type_create_info,                // const void               * pNext
+      0                                           // VkSemaphoreCreateFlags     flags
+    };
+
+    VkResult result = dispatch.vkCreateSemaphore( dispatch.Device, &semaphore_create_info, nullptr, &semaphore );
+    if( VK_SUCCESS != result ) {
+      std::cout << "Could not create a timeline semaphore." << std::endl;
+      return false;
+    }
+    return true;
+  }
+
+  TimelineScheduler::TimelineScheduler() :
+    Dispatch( nullptr ),
+    Batcher( nullptr ) {
+  }
+
+  TimelineScheduler::~TimelineScheduler() {
+    Destroy();
+  }
+
+  bool TimelineScheduler::Initialize( DeviceDispatch const       & dispatch,
+                                      std::vector<VkQueue> const & queues,
+                                      SubmitBatcher              * submit_batcher ) {
+    Destroy();
+
+    if( (nullptr == dispatch.vkWaitSemaphores) ||
+        (nullptr == dispatch.vkGetSemaphoreCounterValue) ) {
+      std::cout << "Could not initialize timeline scheduler - timeline semaphores are not enabled." << std::endl;
+      return false;
+    }
+
+    Dispatch = &dispatch;
+    Batcher = submit_batcher;
+    for( auto queue : queues ) {
+      auto timeline = std::find_if( Timelines.begin(), Timelines.end(), [queue]( Timeline const & timeline ) {
+        return queue == timeline.Queue;
+      } );
+      if( timeline != Timelines.end() ) {
+        QueueTimelines.push_back( static_cast<uint32_t>(timeline - Timelines.begin()) );
+        continue;
+      }
+
+      Timelines.emplace_back();
+      Timeline & new_timeline = Timelines.back();
+      new_timeline.Queue = queue;
+      new_timeline.LastSubmittedValue = 0;
+      new_timeline.CompletedValue = 0;
+      InitVkDestroyer( *Dispatch, new_timeline.Semaphore );
+      if( !CreateTimelineSemaphore( *Dispatch, 0, *new_timeline.Semaphore ) ) {
+        Destroy();
+        return false;
+      }
+      QueueTimelines.push_back( static_cast<uint32_t>(Timelines.size() - 1) );
+    }
+    return true;
+  }
+
+  void TimelineScheduler::Destroy() {
+    if( nullptr == Dispatch ) {
+      return;
+    }
+    if( nullptr != Batcher ) {
+      Batcher->FlushAll();
+    }
+    WaitIdle();
+    Timelines.clear();
+    QueueTimelines.clear();
+    Dispatch = nullptr;
+  }
+
+  bool TimelineScheduler::Submit( uint32_t                    queue,
+                                  ScheduledSubmission const & submission,
+                                  TimelinePoint             & submission_point ) {
+    Timeline * timeline = GetTimeline( queue );
+    if( nullptr == timeline ) {
+      std::cout << "Could not submit to queue " << queue << " - it is not known to the scheduler." << std::endl;
+      return false;
+    }
+
+    SubmitBatch batch;
+    for( auto & dependency : submission.Dependencies ) {
+      Timeline * dependency_timeline = GetTimeline( dependency.Point.Queue );
+      if( (nullptr == dependency_timeline) ||
+          (dependency.Point.Value > dependency_timeline->LastSubmittedValue) ) {
+        // Waiting for a value nobody has submitted yet could stall the queue forever
+        std::cout << "Could not submit - a dependency refers to work which was not submitted." << std::endl;
+        return false;
+      }
+      // Waits on the same timeline are merged into one for the latest value
+      if( dependency.Point.Value > dependency_timeline->CompletedValue ) {
+        batch.WaitSemaphores.push_back( { *dependency_timeline->Semaphore, dependency.Point.Value, dependency.WaitingStage } );
+      }
+    }
+    for( auto & wait_semaphore : submission.WaitSemaphores ) {
+      batch.WaitSemaphores.push_back( { wait_semaphore.Semaphore, 0, wait_semaphore.WaitingStage } );
+    }
+    batch.CommandBuffers = submission.CommandBuffers;
+
+    uint64_t signal_value = timeline->LastSubmittedValue + 1;
+    batch.SignalSemaphores.push_back( { *timeline->Semaphore, signal_value } );
+    for( auto & signal_semaphore : submission.SignalSemaphores ) {
+      batch.SignalSemaphores.push_back( { signal_semaphore, 0 } );
+    }
+
+    if( nullptr != Batcher ) {
+      Batcher->Add( timeline->Queue, batch );
+    } else if( !SubmitBatchesToQueue( *Dispatch, timeline->Queue, { batch }, VK_NULL_HANDLE ) ) {
+      return false;
+    }
+
+    timeline->LastSubmittedValue = signal_value;
+    submission_point = { queue, signal_value };
+    return true;
+  }
+
+  bool TimelineScheduler::IsComplete( TimelinePoint const & point ) {
+    Timeline * timeline = GetTimeline( point.Queue );
+    if( nullptr == timeline ) {
+      return false;
+    }
+    if( point.Value <= timeline->CompletedValue ) {
+      return true;
+    }
+    return point.Value <= GetCompletedValue( point.Queue );
+  }
+
+  bool TimelineScheduler::Wait( std::vector<TimelinePoint> const & points,
+                                bool                               wait_for_all,
+                                uint64_t                           timeout ) {
+    std::vector<VkSemaphore> semaphores;
+    std::vector<uint64_t> values;
+    for( auto & point : points ) {
+      Timeline * timeline = GetTimeline( point.Queue );
+      if( (nullptr == timeline) ||
+          (point.Value > timeline->LastSubmittedValue) ) {
+        std::cout << "Could not wait for work which was not submitted." << std::endl;
+        return false;
+      }
+      if( point.Value <= timeline->CompletedValue ) {
+        if( !wait_for_all ) {
+          return true;
+        }
+        continue;
+      }
+      semaphores.push_back( *timeline->Semaphore );
+      values.push_back( point.Value );
+    }
+    if( semaphores.empty() ) {
+      return true;
+    }
+
+    VkSemaphoreWaitInfo semaphore_wait_info = {
+      VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,                    // VkStructureType          sType
+      nullptr,                                                  // const void             * pNext
+      wait_for_all ? 0u : static_cast<VkSemaphoreWaitFlags>(VK_SEMAPHORE_WAIT_ANY_BIT), // VkSemaphoreWaitFlags     flags
+      static_cast<uint32_t>(semaphores.size()),                 // uint32_t                 semaphoreCount
+      semaphores.data(),                                        // const VkSemaphore      * pSemaphores
+      values.data()                                             // const uint64_t         * pValues
+    };
+
+    VkResult result = Dispatch->vkWaitSemaphores( Dispatch->Device, &semaphore_wait_info, timeout );
+    switch( result ) {
+    case VK_SUCCESS:
+      break;
+    case VK_TIMEOUT:
+      return false;
+    default:
+      std::cout << "Waiting on timeline semaphores failed." << std::endl;
+      return false;
+    }
+
+    if( wait_for_all ) {
+      for( auto & point : points ) {
+        Timeline * timeline = GetTimeline( point.Queue );
+        timeline->CompletedValue = std::max( timeline->CompletedValue, point.Value );
+      }
+    }
+    return true;
+  }
+
+  bool TimelineScheduler::WaitIdle( uint64_t timeout ) {
+    std::vector<TimelinePoint> points;
+    for( uint32_t queue = 0; queue < static_cast<uint32_t>(QueueTimelines.size()); ++queue ) {
+      points.push_back( { queue, GetTimeline( queue )->LastSubmittedValue } );
+    }
+    return Wait( points, true, timeout );
+  }
+
+  uint64_t TimelineScheduler::GetLastSubmittedValue( uint32_t queue ) const {
+    Timeline const * timeline = GetTimeline( queue );
+    return (nullptr != timeline) ? timeline->LastSubmittedValue : 0;
+  }
+
+  uint64_t TimelineScheduler::GetCompletedValue( uint32_t queue ) {
+    Timeline * timeline = GetTimeline( queue );
+    if( nullptr == timeline ) {
+      return 0;
+    }
+    if( timeline->CompletedValue < timeline->LastSubmittedValue ) {
+      uint64_t value;
+      if( VK_SUCCESS == Dispatch->vkGetSemaphoreCounterValue( Dispatch->Device, *timeline->Semaphore, &value ) ) {
+        timeline->CompletedValue = std::max( timeline->CompletedValue, value );
+      }
+    }
+    return timeline->CompletedValue;
+  }
+
+  VkSemaphore TimelineScheduler::GetSemaphore( uint32_t queue ) const {
+    Timeline const * timeline = GetTimeline( queue );
+    return (nullptr != timeline) ? *timeline->Semaphore : VK_NULL_HANDLE;
+  }
+
+  TimelineScheduler::Timeline * TimelineScheduler::GetTimeline( uint32_t queue ) {
+    return (queue < QueueTimelines.size()) ? &Timelines[QueueTimelines[queue]] : nullptr;
+  }
+
+  TimelineScheduler::Timeline const * TimelineScheduler::GetTimeline( uint32_t queue ) const {
+    return (queue < QueueTimelines.size()) ? &Timelines[QueueTimelines[queue]] : nullptr;
+  }
+
+} // namespace VulkanCookbook
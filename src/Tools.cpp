@@ -25,11 +25,19 @@
 //
 // Tools
 
+#include <cstdio>
 #include <fstream>
 #include <iostream>
 #include <cmath>
 #include "Tools.h"
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace VulkanCookbook {
 
   bool GetBinaryFileContents( std::string const          & filename,
@@ -60,6 +68,166 @@ namespace VulkanCookbook {
     return true;
   }
 
+  MappedFile::MappedFile() :
+#ifdef _WIN32
+    File( INVALID_HANDLE_VALUE ),
+    Mapping( nullptr ),
+#else
+    FileDescriptor( -1 ),
+#endif
+    Data( nullptr ),
+    Size( 0 ),
+    Mapped( false ) {
+  }
+
+  MappedFile::~MappedFile() {
+    Close();
+  }
+
+  bool MappedFile::Open( std::string const & filename,
+                         MappedFileHints     hints ) {
+    Close();
+
+#ifdef _WIN32
+    DWORD flags = (0 != (hints & MAPPED_FILE_HINT_SEQUENTIAL_BIT)) ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_ATTRIBUTE_NORMAL;
+    File = CreateFileA( filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, flags, nullptr );
+    if( INVALID_HANDLE_VALUE == File ) {
+      std::cout << "Could not open '" << filename << "' file." << std::endl;
+      return false;
+    }
+    LARGE_INTEGER file_size;
+    if( !GetFileSizeEx( File, &file_size ) ) {
+      std::cout << "Could not get the size of '" << filename << "' file." << std::endl;
+      Close();
+      return false;
+    }
+    Size = static_cast<size_t>(file_size.QuadPart);
+#else
+    FileDescriptor = open( filename.c_str(), O_RDONLY );
+    if( -1 == FileDescriptor ) {
+      std::cout << "Could not open '" << filename << "' file." << std::endl;
+      return false;
+    }
+    struct stat file_status;
+    if( -1 == fstat( FileDescriptor, &file_status ) ) {
+      std::cout << "Could not get the size of '" << filename << "' file." << std::endl;
+      Close();
+      return false;
+    }
+    Size = static_cast<size_t>(file_status.st_size);
+#endif
+
+    if( 0 == Size ) {
+      std::cout << "The '" << filename << "' file is empty." << std::endl;
+      Close();
+      return false;
+    }
+
+#ifdef _WIN32
+    Mapping = CreateFileMappingA( File, nullptr, PAGE_READONLY, 0, 0, nullptr );
+    if( nullptr != Mapping ) {
+      Data = static_cast<unsigned char const *>(MapViewOfFile( Mapping, FILE_MAP_READ, 0, 0, 0 ));
+    }
+#else
+    int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+    if( 0 != (hints & MAPPED_FILE_HINT_POPULATE_BIT) ) {
+      flags |= MAP_POPULATE;
+    }
+#endif
+    void * data = mmap( nullptr, Size, PROT_READ, flags, FileDescriptor, 0 );
+    if( MAP_FAILED != data ) {
+      Data = static_cast<unsigned char const *>(data);
+#ifdef MADV_SEQUENTIAL
+      if( 0 != (hints & MAPPED_FILE_HINT_SEQUENTIAL_BIT) ) {
+        madvise( data, Size, MADV_SEQUENTIAL );
+      }
+#endif
+    }
+#endif
+    if( nullptr != Data ) {
+      Mapped = true;
+      return true;
+    }
+
+    // Some files (e.g. on special file systems) cannot be mapped
+    size_t size = Size;
+    Close();
+    if( !GetBinaryFileContents( filename, FallbackContents ) ||
+        (FallbackContents.size() != size) ) {
+      std::cout << "Could not map '" << filename << "' file into memory." << std::endl;
+      Close();
+      return false;
+    }
+    Data = FallbackContents.data();
+    Size = FallbackContents.size();
+    return true;
+  }
+
+  void MappedFile::Close() {
+#ifdef _WIN32
+    if( Mapped ) {
+      UnmapViewOfFile( Data );
+    }
+    if( nullptr != Mapping ) {
+      CloseHandle( Mapping );
+      Mapping = nullptr;
+    }
+    if( INVALID_HANDLE_VALUE != File ) {
+      CloseHandle( File );
+      File = INVALID_HANDLE_VALUE;
+    }
+#else
+    if( Mapped ) {
+      munmap( const_cast<unsigned char *>(Data), Size );
+    }
+    if( -1 != FileDescriptor ) {
+      close( FileDescriptor );
+      FileDescriptor = -1;
+    }
+#endif
+    Data = nullptr;
+    Size = 0;
+    Mapped = false;
+    std::vector<unsigned char>().swap( FallbackContents );
+  }
+
+  bool GetBinaryFileContents( std::string const & filename,
+                              MappedFile        & file,
+                              ByteSpan          & contents,
+                              MappedFileHints     hints ) {
+    contents = ByteSpan();
+    if( !file.Open( filename, hints ) ) {
+      return false;
+    }
+    contents = file.GetSpan();
+    return true;
+  }
+
+  std::string GetTemporaryFilename( std::string const & target ) {
+#ifdef _WIN32
+    unsigned long process_id = GetCurrentProcessId();
+#else
+    unsigned long process_id = static_cast<unsigned long>(getpid());
+#endif
+    return target + "." + std::to_string( process_id ) + ".tmp";
+  }
+
+  bool ReplaceFileAtomically( std::string const & temporary,
+                              std::string const & target ) {
+#ifdef _WIN32
+    bool renamed = (0 != MoveFileExA( temporary.c_str(), target.c_str(), MOVEFILE_REPLACE_EXISTING ));
+#else
+    bool renamed = (0 == std::rename( temporary.c_str(), target.c_str() ));
+#endif
+    if( !renamed ) {
+      std::cout << "Could not replace '" << target << "' file with '" << temporary << "' file." << std::endl;
+      std::remove( temporary.c_str() );
+      return false;
+    }
+    return true;
+  }
+
   float Deg2Rad( float value ) {
     return value * 0.01745329251994329576923690768489f;
   }
@@ -30,10 +30,13 @@
 namespace VulkanCookbook {
     #define EXPORTED_VULKAN_FUNCTION( name ) PFN_##name name;
     #define GLOBAL_LEVEL_VULKAN_FUNCTION( name ) PFN_##name name;
+    #define GLOBAL_LEVEL_VULKAN_FUNCTION_FROM_VERSION( name, version ) PFN_##name name;
     #define INSTANCE_LEVEL_VULKAN_FUNCTION( name ) PFN_##name name;
     #define INSTANCE_LEVEL_VULKAN_FUNCTION_FROM_EXTENSION( name, extension ) PFN_##name name;
+    #define INSTANCE_LEVEL_VULKAN_FUNCTION_FROM_VERSION( name, version ) PFN_##name name;
     #define DEVICE_LEVEL_VULKAN_FUNCTION( name ) PFN_##name name;
     #define DEVICE_LEVEL_VULKAN_FUNCTION_FROM_EXTENSION( name, extension ) PFN_##name name;
+    #define DEVICE_LEVEL_VULKAN_FUNCTION_FROM_VERSION( name, version, extension, extension_name ) PFN_##name name;
 
     #include "ListOfVulkanFunctions.inl"
 } // namespace VulkanCookbook
@@ -103,8 +103,9 @@ namespace VulkanCookbook {
             return false;
         }
 
+        ExtensionTable available_extension_table( available_extensions );
         for( auto & extension : desired_extensions ) {
-            if( !IsExtensionSupported( available_extensions, extension ) ) {
+            if( !IsExtensionSupported( available_extension_table, extension ) ) {
                 std::cout << "Extension named '" << extension << "' is not supported by an Instance object." << std::endl;
                 return false;
             }
@@ -117,7 +118,7 @@ namespace VulkanCookbook {
             VK_MAKE_VERSION( 1, 0, 0 ),                         // uint32_t                  applicationVersion
             "Vulkan Cookbook",                                  // const char              * pEngineName
             VK_MAKE_VERSION( 1, 0, 0 ),                         // uint32_t                  engineVersion
-            VK_MAKE_VERSION( 1, 0, 0 )                          // uint32_t                  apiVersion
+            SelectInstanceApiVersion()                          // uint32_t                  apiVersion
         };
 
         VkInstanceCreateInfo instance_create_info = {
@@ -246,15 +247,17 @@ namespace VulkanCookbook {
                             std::vector<QueueInfo>            queue_infos,
                             std::vector<char const *> const & desired_extensions,
                             VkPhysicalDeviceFeatures        * desired_features,
-                            VkDevice                        & logical_device ) {
+                            VkDevice                        & logical_device,
+                            void const                      * features_chain ) {
 
         std::vector<VkExtensionProperties> available_extensions;
         if( !CheckAvailableDeviceExtensions( physical_device, available_extensions ) ) {
             return false;
         }
 
+        ExtensionTable available_extension_table( available_extensions );
         for( auto & extension : desired_extensions ) {
-            if( !IsExtensionSupported( available_extensions, extension ) ) {
+            if( !IsExtensionSupported( available_extension_table, extension ) ) {
                 std::cout << "Extension named '" << extension << "' is not supported by a physical device." << std::endl;
                 return false;
             }
@@ -275,7 +278,7 @@ namespace VulkanCookbook {
 
         VkDeviceCreateInfo device_create_info = {
             VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,               // VkStructureType                  sType
-            nullptr,                                            // const void                     * pNext
+            features_chain,                                     // const void                     * pNext
             0,                                                  // VkDeviceCreateFlags              flags
             static_cast<uint32_t>(queue_create_infos.size()),   // uint32_t                         queueCreateInfoCount
             queue_create_infos.data(),                          // const VkDeviceQueueCreateInfo  * pQueueCreateInfos
@@ -299,15 +302,33 @@ namespace VulkanCookbook {
         vkGetDeviceQueue( logical_device, queue_family_index, queue_index, &queue );
     }
 
+    std::vector<QueueInfo> PrepareQueueInfos( QueueLayout const & queue_layout ) {
+        std::vector<QueueInfo> queue_infos;
+        for( auto & request : queue_layout.Requests ) {
+            queue_infos.push_back( { request.FamilyIndex, std::vector<float>( request.QueueCount, 1.0f ) } );
+        }
+        return queue_infos;
+    }
+
 
     bool CreateLogicalDeviceWithGeometryShadersAndGraphicsAndComputeQueues( VkInstance   instance,
                                                                             VkDevice   & logical_device,
                                                                             VkQueue    & graphics_queue,
                                                                             VkQueue    & compute_queue ) {
-        std::vector<VkPhysicalDevice> physical_devices;
-        EnumerateAvailablePhysicalDevices( instance, physical_devices );
+        DeviceRequirements requirements = MakeDeviceRequirements( VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT );
+        requirements.Features.geometryShader = VK_TRUE;
+
+        std::vector<PhysicalDeviceScore> ranked_devices;
+        if( !RankPhysicalDevices( instance, requirements, ranked_devices ) ) {
+            return false;
+        }
+
+        for( auto & ranked_device : ranked_devices ) {
+            VkPhysicalDevice physical_device = ranked_device.PhysicalDevice;
+            if( !ranked_device.MeetsRequirements ) {
+                continue;
+            }
 
-        for( auto & physical_device : physical_devices ) {
             VkPhysicalDeviceFeatures device_features;
             VkPhysicalDeviceProperties device_properties;
             GetFeaturesAndPropertiesOfPhysicalDevice( physical_device, device_features, device_properties );
@@ -319,29 +340,20 @@ namespace VulkanCookbook {
                 device_features.geometryShader = VK_TRUE;
             }
 
-            uint32_t graphics_queue_family_index;
-            if( !SelectIndexOfQueueFamilyWithDesiredCapabilities( physical_device, VK_QUEUE_GRAPHICS_BIT, graphics_queue_family_index ) ) {
+            // Compute lands on an async compute family whenever the device has one
+            QueueLayout queue_layout;
+            if( !SelectQueueLayout( physical_device, VK_NULL_HANDLE, queue_layout ) ) {
                 continue;
             }
 
-            uint32_t compute_queue_family_index;
-            if( !SelectIndexOfQueueFamilyWithDesiredCapabilities( physical_device, VK_QUEUE_COMPUTE_BIT, compute_queue_family_index ) ) {
-                continue;
-            }
-
-            std::vector<QueueInfo> requested_queues = { { graphics_queue_family_index, { 1.0f } } };
-            if( graphics_queue_family_index != compute_queue_family_index ) {
-                requested_queues.push_back( { compute_queue_family_index, { 1.0f } } );
-            }
-
-            if( !CreateLogicalDevice( physical_device, requested_queues, {}, &device_features, logical_device ) ) {
+            if( !CreateLogicalDevice( physical_device, PrepareQueueInfos( queue_layout ), {}, &device_features, logical_device ) ) {
                 continue;
             } else {
-                if( !LoadDeviceLevelFunctions( logical_device, {} ) ) {
+                if( !LoadDeviceLevelFunctions( logical_device, {}, GetNegotiatedApiVersion( physical_device ) ) ) {
                     return false;
                 }
-                GetDeviceQueue( logical_device, graphics_queue_family_index, 0, graphics_queue );
-                GetDeviceQueue( logical_device, compute_queue_family_index, 0, compute_queue );
+                GetDeviceQueue( logical_device, queue_layout.Graphics.FamilyIndex, queue_layout.Graphics.QueueIndex, graphics_queue );
+                GetDeviceQueue( logical_device, queue_layout.Compute.FamilyIndex, queue_layout.Compute.QueueIndex, compute_queue );
                 return true;
             }
         }
@@ -454,10 +466,11 @@ namespace VulkanCookbook {
                                                       std::vector< QueueInfo >    queue_infos,
                                                       std::vector<char const *> & desired_extensions,
                                                       VkPhysicalDeviceFeatures  * desired_features,
-                                                      VkDevice                  & logical_device ) {
+                                                      VkDevice                  & logical_device,
+                                                      void const                * features_chain ) {
         desired_extensions.emplace_back( VK_KHR_SWAPCHAIN_EXTENSION_NAME );
 
-        return CreateLogicalDevice( physical_device, queue_infos, desired_extensions, desired_features, logical_device );
+        return CreateLogicalDevice( physical_device, queue_infos, desired_extensions, desired_features, logical_device, features_chain );
     }
 
     bool SelectDesiredPresentationMode( VkPhysicalDevice   physical_device,
@@ -521,18 +534,143 @@ namespace VulkanCookbook {
         }
         return true;
     }
+
+    // Renders a single frame into an offscreen image and writes it to a PPM
+    // file, so the project can run on machines without a display server
+    bool RenderHeadlessFrame( VkPhysicalDevice    physical_device,
+                              VkExtent2D          size,
+                              std::string const & output_filename ) {
+        uint32_t queue_family_index;
+        if( !SelectIndexOfQueueFamilyWithDesiredCapabilities( physical_device, VK_QUEUE_GRAPHICS_BIT, queue_family_index ) ) {
+            std::cout << "Could not find a graphics queue family for headless rendering." << std::endl;
+            return false;
+        }
+
+        std::vector<char const *> desired_device_extensions;
+        // Every object of the device is destroyed through its dispatch table,
+        // so the table is declared first and outlives all of them
+        DeviceDispatch dispatch = {};
+        VkDestroyer(VkDevice) logical_device;
+        InitVkDestroyer( dispatch, logical_device );
+        if( !CreateLogicalDevice( physical_device, { { queue_family_index, { 1.0f } } }, desired_device_extensions, nullptr, *logical_device ) ) {
+            return false;
+        }
+        if( !LoadDeviceLevelFunctions( *logical_device, desired_device_extensions, dispatch, GetNegotiatedApiVersion( physical_device ) ) ) {
+            return false;
+        }
+
+        VkQueue queue;
+        dispatch.vkGetDeviceQueue( dispatch.Device, queue_family_index, 0, &queue );
+
+        DeviceMemoryAllocator allocator;
+        if( !allocator.Initialize( physical_device, dispatch ) ) {
+            return false;
+        }
+
+        OffscreenRenderTarget render_target;
+        if( !CreateOffscreenRenderTarget( dispatch, allocator, VK_FORMAT_R8G8B8A8_UNORM, size, render_target ) ) {
+            return false;
+        }
+
+        VkDestroyer(VkCommandPool) command_pool;
+        InitVkDestroyer( dispatch, command_pool );
+        if( !CreateCommandPool( dispatch, VK_COMMAND_POOL_CREATE_TRANSIENT_BIT, queue_family_index, *command_pool ) ) {
+            return false;
+        }
+
+        std::vector<VkCommandBuffer> command_buffers;
+        if( !AllocateCommandBuffers( dispatch, *command_pool, VK_COMMAND_BUFFER_LEVEL_PRIMARY, 1, command_buffers ) ) {
+            return false;
+        }
+
+        if( !BeginCommandBufferRecordingOperation( dispatch, command_buffers[0], VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, nullptr ) ) {
+            return false;
+        }
+        RecordOffscreenFrame( dispatch, command_buffers[0], render_target, [&dispatch]( VkCommandBuffer command_buffer, VkImage image ) {
+            VkClearColorValue clear_color = { { 0.1f, 0.2f, 0.4f, 1.0f } };
+            VkImageSubresourceRange range = {
+                VK_IMAGE_ASPECT_COLOR_BIT,    // VkImageAspectFlags     aspectMask
+                0,                            // uint32_t               baseMipLevel
+                1,                            // uint32_t               levelCount
+                0,                            // uint32_t               baseArrayLayer
+                1                             // uint32_t               layerCount
+            };
+            dispatch.vkCmdClearColorImage( command_buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &clear_color, 1, &range );
+        } );
+        if( !EndCommandBufferRecordingOperation( dispatch, command_buffers[0] ) ) {
+            return false;
+        }
+
+        FencePool fence_pool;
+        CompletionTracker completion_tracker;
+        fence_pool.Initialize( dispatch );
+        completion_tracker.Initialize( dispatch, fence_pool );
+
+        VkFence fence;
+        uint64_t submission_id;
+        if( !completion_tracker.BeginSubmission( fence, submission_id ) ) {
+            return false;
+        }
+        if( !SubmitCommandBuffersToQueue( dispatch, queue, {}, command_buffers, {}, fence ) ) {
+            completion_tracker.CancelSubmission( submission_id );
+            return false;
+        }
+        if( !completion_tracker.WaitForSubmission( submission_id, 5000000000 ) ) {
+            return false;
+        }
+
+        std::vector<unsigned char> pixels;
+        if( !ReadOffscreenRenderTarget( allocator, render_target, pixels ) ) {
+            return false;
+        }
+        if( !SaveImageAsPpm( output_filename, size, pixels ) ) {
+            return false;
+        }
+        std::cout << "Saved headless frame to '" << output_filename << "'." << std::endl;
+        return true;
+    }
 } //VulkanCookbook
 
 
 int main(int argc, char * argv[]) {
 
     bool enable_verbose = false;
+    std::string pipeline_cache_filename = "pipeline_cache.bin";
+    bool headless = false;
+    std::string headless_output_filename = "frame.ppm";
+    uint32_t frame_count = 300;
+    uint32_t frames_in_flight = 0;
+    VulkanCookbook::PresentProfile present_profile = VulkanCookbook::PresentProfile::LowLatency;
+    std::string device_override;
     for ( int i = 0; i < argc; i = i + 1 ){
         if ((strcmp(argv[i], "-v") == 0) || (strcmp(argv[i], "--verbose") == 0)) {
             enable_verbose = true;
             std::cout << "Enabled verbose" << std::endl;
+        } else if ((strcmp(argv[i], "--pipeline-cache") == 0) && (i + 1 < argc)) {
+            pipeline_cache_filename = argv[++i];
+        } else if (strcmp(argv[i], "--headless") == 0) {
+            headless = true;
+        } else if ((strcmp(argv[i], "--output") == 0) && (i + 1 < argc)) {
+            headless_output_filename = argv[++i];
+        } else if ((strcmp(argv[i], "--frames") == 0) && (i + 1 < argc)) {
+            frame_count = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        } else if ((strcmp(argv[i], "--frames-in-flight") == 0) && (i + 1 < argc)) {
+            frames_in_flight = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        } else if ((strcmp(argv[i], "--device") == 0) && (i + 1 < argc)) {
+            device_override = argv[++i];
+        } else if ((strcmp(argv[i], "--present-profile") == 0) && (i + 1 < argc)) {
+            if (!VulkanCookbook::ParsePresentProfile(argv[++i], present_profile)) {
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--benchmark") == 0) {
+            // CPU only, does not need a Vulkan runtime
+            VulkanCookbook::BenchmarkMathKernels();
+            return 0;
         }
     }
+    if (frames_in_flight == 0) {
+        frames_in_flight = VulkanCookbook::GetFramesInFlightForProfile(present_profile);
+    }
 
 
     void* vulkan_library = dlopen("libvulkan.so", RTLD_NOW);
@@ -567,24 +705,29 @@ int main(int argc, char * argv[]) {
         //"VK_KHR_get_physical_device_properties2",
         //"VK_KHR_get_surface_capabilities2",
         //"VK_KHR_surface_protected_capabilities",
-        "VK_KHR_display",
         "VK_EXT_debug_report",
         "VK_EXT_debug_utils"
         //"VK_EXT_acquire_drm_display",
         //"VK_EXT_acquire_xlib_display"
         };
+    if (headless == false) {
+        desired_extensions.push_back("VK_KHR_display");
+    }
 
 
+    VulkanCookbook::ExtensionTable available_extension_table(available_extensions);
     for( auto & extension : desired_extensions ) {
-        if( !VulkanCookbook::IsExtensionSupported( available_extensions, extension ) ) {
+        if( !VulkanCookbook::IsExtensionSupported( available_extension_table, extension ) ) {
             std::cout << "Extension named '" << extension << "' is not supported by an Instance object." << std::endl;
             return false;
         }
     }
 
-    std::vector<char const*> desired_layers = {
-        "VK_LAYER_LUNARG_monitor"
-    };
+    // The monitor layer draws into the swapchain, so it is useless without a window
+    std::vector<char const*> desired_layers;
+    if (headless == false) {
+        desired_layers.push_back("VK_LAYER_LUNARG_monitor");
+    }
 
     if (enable_verbose == true) {
         desired_layers.push_back("VK_LAYER_KHRONOS_validation");
@@ -599,7 +742,11 @@ int main(int argc, char * argv[]) {
         }
     }
 
-    VulkanCookbook::CreateVulkanInstanceWithWSIExtensionsEnabled(instance, desired_extensions);
+    if (headless == true) {
+        VulkanCookbook::CreateVulkanInstance(desired_extensions, "vulkan_test", instance);
+    } else {
+        VulkanCookbook::CreateVulkanInstanceWithWSIExtensionsEnabled(instance, desired_extensions);
+    }
     bool lilf = VulkanCookbook::LoadInstanceLevelFunctions(instance, desired_extensions);
 
     bool debug_callbacks = false;
@@ -641,13 +788,22 @@ int main(int argc, char * argv[]) {
         std::cout << "\t\tAvailable queue families : " << queue_families.size() << std::endl;
 
         uint32_t queue_family_index;
-        VkQueueFlags desired_capabilities = VK_QUEUE_GRAPHICS_BIT || VK_QUEUE_COMPUTE_BIT || VK_QUEUE_TRANSFER_BIT;
+        VkQueueFlags desired_capabilities = VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT | VK_QUEUE_TRANSFER_BIT;
 
         VulkanCookbook::SelectIndexOfQueueFamilyWithDesiredCapabilities(physical_device, desired_capabilities, queue_family_index);
         std::cout << "\t\tQueue family index : " << queue_family_index << std::endl;
     }
 
 
+    if (headless == true) {
+        VkPhysicalDevice headless_physical_device = VK_NULL_HANDLE;
+        bool headless_result = VulkanCookbook::SelectPhysicalDevice(instance, VulkanCookbook::MakeDeviceRequirements(VK_QUEUE_GRAPHICS_BIT), device_override, headless_physical_device) &&
+                               VulkanCookbook::RenderHeadlessFrame(headless_physical_device, { 640, 480 }, headless_output_filename);
+        VulkanCookbook::DestroyVulkanInstance(instance);
+        VulkanCookbook::ReleaseVulkanLoaderLibrary(vulkan_library);
+        return headless_result ? 0 : 1;
+    }
+
     std::vector<char const*> desired_device_extensions;
     /*/
     = {
@@ -807,41 +963,162 @@ int main(int argc, char * argv[]) {
     VulkanCookbook::CreateLogicalDeviceWithGeometryShadersAndGraphicsAndComputeQueues(instance, logical_device, graphics_queue, compute_queue);
 
     WindowParameters window_parameters;
-    int displays[1];
-    displays[0] = 1;
-    window_parameters.Connection = xcb_connect(":0", displays);
+    int screen_index = 0;
+    window_parameters.Connection = xcb_connect(nullptr, &screen_index);
+    if (xcb_connection_has_error(window_parameters.Connection)) {
+        std::cout << "Could not connect to the X server. Use --headless to render without a window." << std::endl;
+        xcb_disconnect(window_parameters.Connection);
+        VulkanCookbook::DestroyLogicalDevice(logical_device);
+        VulkanCookbook::DestroyVulkanInstance(instance);
+        VulkanCookbook::ReleaseVulkanLoaderLibrary(vulkan_library);
+        return 1;
+    }
+    xcb_screen_iterator_t screen_iterator = xcb_setup_roots_iterator(xcb_get_setup(window_parameters.Connection));
+    for (int i = 0; i < screen_index; ++i) {
+        xcb_screen_next(&screen_iterator);
+    }
+    xcb_screen_t * screen = screen_iterator.data;
+
     window_parameters.Window = xcb_generate_id(window_parameters.Connection);
+    uint32_t window_event_mask = XCB_EVENT_MASK_STRUCTURE_NOTIFY;
+    xcb_create_window(window_parameters.Connection, XCB_COPY_FROM_PARENT, window_parameters.Window, screen->root,
+                      0, 0, 640, 480, 0, XCB_WINDOW_CLASS_INPUT_OUTPUT, screen->root_visual, XCB_CW_EVENT_MASK, &window_event_mask);
+    xcb_map_window(window_parameters.Connection, window_parameters.Window);
+    xcb_flush(window_parameters.Connection);
 
     VkSurfaceKHR presentation_surface;
     VulkanCookbook::CreatePresentationSurface(instance, window_parameters, presentation_surface);
 
-    uint32_t queue_family_index;
-    VulkanCookbook::SelectQueueFamilyWithPresentationToSurface(physical_devices[0], presentation_surface, queue_family_index);
-    std::cout << "Queue Family Index : " << queue_family_index << std::endl;
+    VulkanCookbook::DeviceRequirements device_requirements = VulkanCookbook::MakeDeviceRequirements(VK_QUEUE_GRAPHICS_BIT);
+    device_requirements.Extensions = { VK_KHR_SWAPCHAIN_EXTENSION_NAME };
+    device_requirements.PresentationSurface = presentation_surface;
+
+    VkPhysicalDevice physical_device = VK_NULL_HANDLE;
+    if (!VulkanCookbook::SelectPhysicalDevice(instance, device_requirements, device_override, physical_device)) {
+        VulkanCookbook::DestroyLogicalDevice(logical_device);
+        VulkanCookbook::vkDestroySurfaceKHR(instance, presentation_surface, nullptr);
+        VulkanCookbook::DestroyVulkanInstance(instance);
+        VulkanCookbook::ReleaseVulkanLoaderLibrary(vulkan_library);
+        xcb_destroy_window(window_parameters.Connection, window_parameters.Window);
+        xcb_disconnect(window_parameters.Connection);
+        return 1;
+    }
+
+    VkPhysicalDeviceProperties device_properties;
+    VulkanCookbook::vkGetPhysicalDeviceProperties( physical_device, &device_properties );
+    std::cout << "Selected device : " << device_properties.deviceName << std::endl;
+
+    VulkanCookbook::QueueLayout queue_layout;
+    VulkanCookbook::SelectQueueLayout(physical_device, presentation_surface, queue_layout);
+    std::cout << "Graphics queue : family " << queue_layout.Graphics.FamilyIndex << ", index " << queue_layout.Graphics.QueueIndex << std::endl;
+    std::cout << "Compute queue : family " << queue_layout.Compute.FamilyIndex << ", index " << queue_layout.Compute.QueueIndex << std::endl;
+    std::cout << "Transfer queue : family " << queue_layout.Transfer.FamilyIndex << ", index " << queue_layout.Transfer.QueueIndex << std::endl;
+    std::cout << "Present queue : family " << queue_layout.Present.FamilyIndex << ", index " << queue_layout.Present.QueueIndex << std::endl;
 
-    std::vector< QueueInfo > queue_infos;
-    QueueInfo queue_info;
-    queue_info.FamilyIndex = 0; //queue_family_index;
-    queue_info.Priorities = {1.0f, 1.0f};
-    queue_infos.push_back(queue_info);
+    std::vector< QueueInfo > queue_infos = VulkanCookbook::PrepareQueueInfos(queue_layout);
     VkPhysicalDeviceFeatures desired_features;
-    VulkanCookbook::vkGetPhysicalDeviceFeatures( physical_devices[0], &desired_features );
+    VulkanCookbook::vkGetPhysicalDeviceFeatures( physical_device, &desired_features );
+
+    VkPhysicalDeviceTimelineSemaphoreFeatures timeline_semaphore_features;
+    bool timeline_semaphores = VulkanCookbook::PrepareTimelineSemaphoreFeatures(physical_device, desired_device_extensions, timeline_semaphore_features);
+    std::cout << "Timeline semaphores : " << (timeline_semaphores ? "enabled" : "not supported") << std::endl;
+
+    VulkanCookbook::CreateLogicalDeviceWithWsiExtensionsEnabled(physical_device, queue_infos, desired_device_extensions, &desired_features, logical_device,
+                                                                timeline_semaphores ? &timeline_semaphore_features : nullptr);
+    VulkanCookbook::DeviceDispatch dispatch;
+    VulkanCookbook::LoadDeviceLevelFunctions(logical_device, desired_device_extensions, dispatch, VulkanCookbook::GetNegotiatedApiVersion(physical_device));
+
+    VulkanCookbook::DeviceQueues device_queues;
+    VulkanCookbook::GetDeviceQueues(dispatch, queue_layout, device_queues);
 
-    VulkanCookbook::CreateLogicalDeviceWithWsiExtensionsEnabled(physical_devices[0], queue_infos, desired_device_extensions, &desired_features, logical_device);
+    VkPipelineCache pipeline_cache = VK_NULL_HANDLE;
+    VulkanCookbook::LoadPipelineCacheFromFile(dispatch, device_properties, pipeline_cache_filename, pipeline_cache);
 
     VkPresentModeKHR present_mode;
-    VulkanCookbook::SelectDesiredPresentationMode(physical_devices[0], presentation_surface, VK_PRESENT_MODE_MAILBOX_KHR, present_mode);
+    VulkanCookbook::SelectPresentModeForProfile(physical_device, presentation_surface, present_profile, present_mode);
+    std::cout << "Present profile : " << VulkanCookbook::GetPresentProfileName(present_profile) << std::endl;
     std::cout << "Selected present mode : " << present_mode << std::endl;
 
     VkSurfaceCapabilitiesKHR surface_capabilities;
-    VulkanCookbook::GetCapabilitiesOfPresentationSurface( physical_devices[0], presentation_surface, surface_capabilities );
+    VulkanCookbook::GetCapabilitiesOfPresentationSurface( physical_device, presentation_surface, surface_capabilities );
 
     uint32_t number_of_images;
-    VulkanCookbook::SelectNumberOfSwapchainImages(surface_capabilities, number_of_images);
+    VulkanCookbook::SelectNumberOfSwapchainImagesForProfile(surface_capabilities, present_profile, present_mode, number_of_images);
     std::cout << "Selected number of images : " << number_of_images << std::endl;
 
-    VulkanCookbook::DestroyLogicalDevice(logical_device);
+    VkImageUsageFlags swapchain_image_usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+    VulkanCookbook::SwapchainState swapchain;
+    VulkanCookbook::CreateSwapchainWithImageViews(physical_device, dispatch, presentation_surface, number_of_images, present_mode,
+                                                  swapchain_image_usage, VK_NULL_HANDLE, { queue_layout.Graphics.FamilyIndex, queue_layout.Present.FamilyIndex }, swapchain);
+
+    // Collects the submissions of a frame, so each queue gets a single vkQueueSubmit
+    VulkanCookbook::SubmitBatcher submit_batcher;
+    submit_batcher.Initialize(dispatch);
+    VulkanCookbook::FrameLoop frame_loop;
+    frame_loop.Initialize(dispatch, queue_layout.Graphics.FamilyIndex, device_queues.Graphics, queue_layout.Present.FamilyIndex, device_queues.Present,
+                          frames_in_flight, &submit_batcher);
+    std::cout << "Frames in flight : " << frame_loop.GetFramesInFlight() << std::endl;
+
+    // Clears every swapchain image with a color that changes over time
+    auto record_frame = [&](VkCommandBuffer command_buffer, uint32_t image_index) {
+        VkImage image = swapchain.Images[image_index];
+        VulkanCookbook::SetImageMemoryBarrier(dispatch, command_buffer, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, { {
+            image, 0, VK_ACCESS_TRANSFER_WRITE_BIT, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED, VK_IMAGE_ASPECT_COLOR_BIT
+        } });
+
+        float phase = static_cast<float>(frame_loop.GetFrameIndex() % 120) / 120.0f;
+        VkClearColorValue clear_color = { { phase, 0.2f, 1.0f - phase, 1.0f } };
+        VkImageSubresourceRange range = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+        dispatch.vkCmdClearColorImage(command_buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &clear_color, 1, &range);
+
+        VulkanCookbook::SetImageMemoryBarrier(dispatch, command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, { {
+            image, VK_ACCESS_TRANSFER_WRITE_BIT, 0, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+            VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED, VK_IMAGE_ASPECT_COLOR_BIT
+        } });
+        return true;
+    };
+
+    for (uint32_t frame = 0; frame < frame_count; ++frame) {
+        bool window_resized = false;
+        xcb_generic_event_t * event;
+        while ((event = xcb_poll_for_event(window_parameters.Connection)) != nullptr) {
+            if ((event->response_type & 0x7f) == XCB_CONFIGURE_NOTIFY) {
+                xcb_configure_notify_event_t * configure_event = reinterpret_cast<xcb_configure_notify_event_t *>(event);
+                if ((configure_event->width != swapchain.Size.width) || (configure_event->height != swapchain.Size.height)) {
+                    window_resized = true;
+                }
+            }
+            free(event);
+        }
+
+        // Old swapchains are retired inside the frame loop, never with vkDeviceWaitIdle
+        if (window_resized || frame_loop.IsSwapchainOutOfDate() || !swapchain.Handle) {
+            if (!frame_loop.RecreateSwapchain(physical_device, presentation_surface, number_of_images, present_mode, swapchain_image_usage, swapchain)) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                continue;
+            }
+        }
+        if (!frame_loop.RenderFrame(swapchain, record_frame)) {
+            break;
+        }
+    }
+
+    frame_loop.Destroy();
+    VulkanCookbook::DestroySwapchain(swapchain);
+    VulkanCookbook::SubmitBatcherStatistics submit_statistics = submit_batcher.GetStatistics();
+    std::cout << "Queue submits : " << submit_statistics.QueueSubmits << " for " << submit_statistics.Batches << " batches" << std::endl;
+
+    if (pipeline_cache != VK_NULL_HANDLE) {
+        VulkanCookbook::SavePipelineCacheToFile(dispatch, pipeline_cache, pipeline_cache_filename);
+        dispatch.vkDestroyPipelineCache(logical_device, pipeline_cache, nullptr);
+    }
+
+    dispatch.vkDestroyDevice(logical_device, nullptr);
+    VulkanCookbook::vkDestroySurfaceKHR(instance, presentation_surface, nullptr);
     VulkanCookbook::DestroyVulkanInstance(instance);
     VulkanCookbook::ReleaseVulkanLoaderLibrary(vulkan_library);
+    xcb_destroy_window(window_parameters.Connection, window_parameters.Window);
+    xcb_disconnect(window_parameters.Connection);
     return 0;
 }
\ No newline at end of file